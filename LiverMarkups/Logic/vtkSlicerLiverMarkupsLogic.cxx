@@ -40,6 +40,7 @@
 
 // Liver Markups MRML includes
 #include "vtkMRMLMarkupsBezierSurfaceNode.h"
+#include "vtkMRMLMarkupsBSplineSurfaceNode.h"
 #include "vtkMRMLMarkupsSlicingContourNode.h"
 #include "vtkMRMLMarkupsDistanceContourNode.h"
 
@@ -88,6 +89,7 @@ void vtkSlicerLiverMarkupsLogic::RegisterNodes()
   scene->RegisterNodeClass(vtkSmartPointer<vtkMRMLMarkupsSlicingContourNode>::New());
   scene->RegisterNodeClass(vtkSmartPointer<vtkMRMLMarkupsDistanceContourNode>::New());
   scene->RegisterNodeClass(vtkSmartPointer<vtkMRMLMarkupsBezierSurfaceNode>::New());
+  scene->RegisterNodeClass(vtkSmartPointer<vtkMRMLMarkupsBSplineSurfaceNode>::New());
 }
 
 //---------------------------------------------------------------------------
@@ -137,6 +139,11 @@ void vtkSlicerLiverMarkupsLogic::ObserveMRMLScene()
                                                   bezierSurfaceNode->GetAddIcon(),
                                                   bezierSurfaceNode->GetMarkupType());
 
+    auto bsplineSurfaceNode = vtkSmartPointer<vtkMRMLMarkupsBSplineSurfaceNode>::New();
+    selectionNode->AddNewPlaceNodeClassNameToList(bsplineSurfaceNode->GetClassName(),
+                                                  bsplineSurfaceNode->GetAddIcon(),
+                                                  bsplineSurfaceNode->GetMarkupType());
+
     // trigger an update on the mouse mode toolbar
     this->GetMRMLScene()->EndState(vtkMRMLScene::BatchProcessState);
     }
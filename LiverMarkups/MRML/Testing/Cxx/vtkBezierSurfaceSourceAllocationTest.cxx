@@ -0,0 +1,221 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSourceAllocationTest.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkBezierSurfaceSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+//-------------------------------------------------------------------------------
+// Every operator new of the test driver (and, where the platform resolves it
+// to the executable, of the libraries it loads) is counted.
+namespace
+{
+std::atomic<long> NumberOfAllocations(0);
+}
+
+void *operator new(std::size_t size)
+{
+  ++NumberOfAllocations;
+  if (void *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+    return pointer;
+    }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+//-------------------------------------------------------------------------------
+// Source attaching persistent points, normals and polygons to its output,
+// as vtkBezierSurfaceSource does, without computing anything. Its executions
+// measure the allocations of the pipeline itself.
+class vtkAllocationReferenceSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkAllocationReferenceSource *New();
+  vtkTypeMacro(vtkAllocationReferenceSource, vtkPolyDataAlgorithm);
+
+protected:
+  vtkAllocationReferenceSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Points->SetDataTypeToDouble();
+    this->Points->SetNumberOfPoints(3);
+    this->Normals->SetNumberOfComponents(3);
+    this->Normals->SetNumberOfTuples(3);
+    this->Normals->SetName("Normals");
+    vtkIdType triangle[3] = {0, 1, 2};
+    this->Polys->InsertNextCell(3, triangle);
+    }
+  ~vtkAllocationReferenceSource() override = default;
+
+  int RequestData(vtkInformation *vtkNotUsed(request),
+                  vtkInformationVector **vtkNotUsed(inputVector),
+                  vtkInformationVector *outputVector) override
+    {
+    vtkInformation *outputInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outputInfo->Get(vtkDataObject::DATA_OBJECT()));
+    this->Points->Modified();
+    output->SetPoints(this->Points);
+    output->GetPointData()->SetNormals(this->Normals);
+    output->SetPolys(this->Polys);
+    return 1;
+    }
+
+  vtkNew<vtkPoints> Points;
+  vtkNew<vtkDoubleArray> Normals;
+  vtkNew<vtkCellArray> Polys;
+};
+
+vtkStandardNewMacro(vtkAllocationReferenceSource);
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Allocations made by one execution of a source
+template <typename Functor>
+long CountAllocations(vtkPolyDataAlgorithm *source, Functor &&modify)
+{
+  modify();
+  long before = NumberOfAllocations;
+  source->Update();
+  return NumberOfAllocations - before;
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+// Interactive updates (one control point moved, as when dragging it) must
+// reuse the buffers and the output objects of the source: an update may not
+// allocate more than the pipeline does for a source that computes nothing.
+int vtkBezierSurfaceSourceAllocationTest(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
+{
+  const int numberOfUpdates = 100;
+
+  vtkNew<vtkAllocationReferenceSource> referenceSource;
+  referenceSource->Update();
+  referenceSource->Update();
+  long pipelineAllocations = 0;
+  for (int update=0; update<4; update++)
+    {
+    pipelineAllocations = std::max(pipelineAllocations,
+      CountAllocations(referenceSource, [&]() {referenceSource->Modified();}));
+    }
+
+  vtkNew<vtkBezierSurfaceSource> source;
+  source->SetResolution(50, 50);
+  source->ComputeNormalsOn();
+  vtkSmartPointer<vtkPoints> controlPoints = source->GetControlPoints();
+  source->SetControlPoints(controlPoints);
+
+  auto moveControlPoint = [&](int update)
+    {
+    double point[3];
+    controlPoints->GetPoint(update % 16, point);
+    point[2] = 0.01*(update % 7);
+    controlPoints->SetPoint(update % 16, point);
+    source->SetControlPoints(controlPoints);
+    };
+
+  // The first executions size the buffers of the source
+  for (int update=0; update<4; update++)
+    {
+    moveControlPoint(update);
+    source->Update();
+    }
+
+  vtkPolyData *output = source->GetOutput();
+  vtkPoints *outputPoints = output->GetPoints();
+  void *outputPointsData = outputPoints->GetData()->GetVoidPointer(0);
+  void *outputNormalsData = output->GetPointData()->GetNormals()->GetVoidPointer(0);
+
+  long totalAllocations = 0;
+  long maximumAllocations = 0;
+  for (int update=0; update<numberOfUpdates; update++)
+    {
+    long allocations = CountAllocations(source, [&]() {moveControlPoint(update);});
+    totalAllocations += allocations;
+    maximumAllocations = std::max(maximumAllocations, allocations);
+    }
+
+  std::cout << "Allocations per interactive update of a 50x50 surface: "
+            << static_cast<double>(totalAllocations)/numberOfUpdates
+            << " (pipeline: " << pipelineAllocations << ")" << std::endl;
+
+  if (maximumAllocations > pipelineAllocations)
+    {
+    std::cerr << "An interactive update allocated " << maximumAllocations
+              << " times, the pipeline alone " << pipelineAllocations << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  output = source->GetOutput();
+  if (output->GetPoints() != outputPoints ||
+      output->GetPoints()->GetData()->GetVoidPointer(0) != outputPointsData ||
+      output->GetPointData()->GetNormals()->GetVoidPointer(0) != outputNormalsData)
+    {
+    std::cerr << "The output points or normals were reallocated" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,626 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkBSplineSurfaceSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Regions of the grid with fewer samples than this are evaluated serially
+const vtkIdType BSplineParallelGrainSize = 4096;
+
+//-------------------------------------------------------------------------------
+// Clamped uniform knot vector of a B-spline of the given degree: degree+1
+// knots at each end and uniformly spaced interior knots.
+std::vector<double> BSplineClampedKnots(unsigned int numberOfControlPoints,
+                                        unsigned int degree)
+{
+  unsigned int numberOfSpans = numberOfControlPoints-degree;
+  std::vector<double> knots(numberOfControlPoints+degree+1, 1.0);
+  for (unsigned int k=0; k<=degree; k++)
+    {
+    knots[k] = 0.0;
+    }
+  for (unsigned int k=1; k<numberOfSpans; k++)
+    {
+    knots[degree+k] = static_cast<double>(k)/numberOfSpans;
+    }
+
+  return knots;
+}
+
+//-------------------------------------------------------------------------------
+// Non-zero B-spline basis functions N(span-degree..span) at t and their first
+// derivatives (Piegl and Tiller, The NURBS Book, algorithms A2.2 and A2.3).
+void EvaluateBSplineBasis(const std::vector<double> &knots, unsigned int degree,
+                          unsigned int span, double t,
+                          double *basis, double *derivative)
+{
+  std::vector<double> left(degree+2, 0.0);
+  std::vector<double> right(degree+2, 0.0);
+
+  basis[0] = 1.0;
+  for (unsigned int j=1; j<=degree; j++)
+    {
+    left[j] = t-knots[span+1-j];
+    right[j] = knots[span+j]-t;
+
+    // The derivatives of degree p are combinations of the basis of degree
+    // p-1, which is in basis before the last step
+    if (j == degree)
+      {
+      for (unsigned int r=0; r<=degree; r++)
+        {
+        double derivativeValue = 0.0;
+        if (r > 0)
+          {
+          double length = right[r]+left[degree-r+1];
+          derivativeValue += (length > 0.0) ? basis[r-1]/length : 0.0;
+          }
+        if (r < degree)
+          {
+          double length = right[r+1]+left[degree-r];
+          derivativeValue -= (length > 0.0) ? basis[r]/length : 0.0;
+          }
+        derivative[r] = degree*derivativeValue;
+        }
+      }
+
+    double saved = 0.0;
+    for (unsigned int r=0; r<j; r++)
+      {
+      double length = right[r+1]+left[j-r];
+      double temp = (length > 0.0) ? basis[r]/length : 0.0;
+      basis[r] = saved+right[r+1]*temp;
+      saved = left[j-r]*temp;
+      }
+    basis[j] = saved;
+    }
+
+  if (degree == 0)
+    {
+    derivative[0] = 0.0;
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Basis tables of the samples of the grid along one parametric direction,
+// with spanResolution segments per knot span, and the range of samples
+// influenced by every control point.
+void BuildBSplineBasisTables(unsigned int numberOfControlPoints, unsigned int degree,
+                             unsigned int spanResolution,
+                             std::vector<unsigned int> &firstControlPoint,
+                             std::vector<double> &basis,
+                             std::vector<double> &derivativeBasis,
+                             std::vector<unsigned int> &firstInfluencedSample,
+                             std::vector<unsigned int> &lastInfluencedSample)
+{
+  std::vector<double> knots = BSplineClampedKnots(numberOfControlPoints, degree);
+  unsigned int numberOfSpans = numberOfControlPoints-degree;
+  unsigned int numberOfSamples = numberOfSpans*spanResolution+1;
+
+  firstControlPoint.resize(numberOfSamples);
+  basis.resize(numberOfSamples*(degree+1));
+  derivativeBasis.resize(numberOfSamples*(degree+1));
+  firstInfluencedSample.assign(numberOfControlPoints, std::numeric_limits<unsigned int>::max());
+  lastInfluencedSample.assign(numberOfControlPoints, 0);
+
+  for (unsigned int k=0; k<numberOfSamples; k++)
+    {
+    double t = static_cast<double>(k)/(numberOfSamples-1);
+    unsigned int span = std::min(k/spanResolution, numberOfSpans-1);
+    EvaluateBSplineBasis(knots, degree, span+degree, t,
+                         &basis[k*(degree+1)], &derivativeBasis[k*(degree+1)]);
+
+    firstControlPoint[k] = span;
+    for (unsigned int a=0; a<=degree; a++)
+      {
+      firstInfluencedSample[span+a] = std::min(firstInfluencedSample[span+a], k);
+      lastInfluencedSample[span+a] = std::max(lastInfluencedSample[span+a], k);
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkSmartPointer<vtkCellArray> BuildBSplineGridTopology(unsigned int xRes, unsigned int yRes)
+{
+  auto topology = vtkSmartPointer<vtkCellArray>::New();
+  topology->AllocateEstimate(2*(xRes-1)*(yRes-1), 3);
+
+  for (unsigned int i=0; i+1<xRes; i++)
+    {
+    for (unsigned int j=0; j+1<yRes; j++)
+      {
+      vtkIdType lower[3] = {i*yRes+j, (i+1)*yRes+j, (i+1)*yRes+j+1};
+      vtkIdType upper[3] = {i*yRes+j, (i+1)*yRes+j+1, i*yRes+j+1};
+      topology->InsertNextCell(3, lower);
+      topology->InsertNextCell(3, upper);
+      }
+    }
+
+  return topology;
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBSplineSurfaceSource);
+
+//-------------------------------------------------------------------------------
+vtkBSplineSurfaceSource::vtkBSplineSurfaceSource()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->ControlPoints = vtkSmartPointer<vtkPoints>::New();
+  this->ControlPoints->SetDataTypeToDouble();
+  this->OutputPoints = vtkSmartPointer<vtkPoints>::New();
+  this->NumberOfControlPoints[0] = 0;
+  this->NumberOfControlPoints[1] = 0;
+  this->Degree[0] = 3;
+  this->Degree[1] = 3;
+  this->SpanResolution[0] = 8;
+  this->SpanResolution[1] = 8;
+  this->GridResolution[0] = 0;
+  this->GridResolution[1] = 0;
+  this->ComputeNormals = false;
+  this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->StructureValid = false;
+  this->EvaluatedNormals = false;
+  this->EvaluatedPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->NumberOfEvaluatedPoints = 0;
+  this->SetNumberOfControlPoints(4,4);
+}
+
+//-------------------------------------------------------------------------------
+vtkBSplineSurfaceSource::~vtkBSplineSurfaceSource() = default;
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of Control Points: " << this->NumberOfControlPoints[0]
+     << ", " << this->NumberOfControlPoints[1] << "\n";
+  os << indent << "Degree: " << this->GetDegreeX() << ", " << this->GetDegreeY() << "\n";
+  os << indent << "Span Resolution: " << this->SpanResolution[0] << ", "
+     << this->SpanResolution[1] << "\n";
+  os << indent << "Compute Normals: " << this->ComputeNormals << "\n";
+  os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Number of Evaluated Points: " << this->NumberOfEvaluatedPoints << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::SetControlPoints(vtkPoints *points)
+{
+  vtkIdType numberOfControlPoints =
+    static_cast<vtkIdType>(this->NumberOfControlPoints[0])*this->NumberOfControlPoints[1];
+  if (points == nullptr || points->GetNumberOfPoints() < numberOfControlPoints)
+    {
+    vtkErrorMacro("SetControlPoints: expected " << numberOfControlPoints << " control points.");
+    return;
+    }
+
+  bool modified = false;
+  for (vtkIdType k=0; k<numberOfControlPoints; k++)
+    {
+    double point[3];
+    double current[3];
+    points->GetPoint(k, point);
+    this->ControlPoints->GetPoint(k, current);
+    if (point[0] != current[0] || point[1] != current[1] || point[2] != current[2])
+      {
+      this->ControlPoints->SetPoint(k, point);
+      modified = true;
+      }
+    }
+
+  if (modified)
+    {
+    this->ControlPoints->Modified();
+    this->Modified();
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkPoints *vtkBSplineSurfaceSource::GetControlPoints() const
+{
+  return this->ControlPoints;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::SetNumberOfControlPoints(unsigned int m, unsigned int n)
+{
+  // Assignment of less than 2 control points in any dimension will result in
+  // 2 control points
+  unsigned int xGrid = (m<2) ? 2 : m;
+  unsigned int yGrid = (n<2) ? 2 : n;
+
+  if (this->NumberOfControlPoints[0] == xGrid && this->NumberOfControlPoints[1] == yGrid)
+    {
+    return;
+    }
+
+  this->NumberOfControlPoints[0] = xGrid;
+  this->NumberOfControlPoints[1] = yGrid;
+  this->ControlPoints->SetNumberOfPoints(xGrid*yGrid);
+  this->StructureValid = false;
+  this->ResetControlPoints();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::SetDegree(unsigned int p, unsigned int q)
+{
+  p = std::max(p, 1u);
+  q = std::max(q, 1u);
+  if (this->Degree[0] == p && this->Degree[1] == q)
+    {
+    return;
+    }
+
+  this->Degree[0] = p;
+  this->Degree[1] = q;
+  this->StructureValid = false;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+unsigned int vtkBSplineSurfaceSource::GetDegreeX() const
+{
+  return std::min(this->Degree[0], this->NumberOfControlPoints[0]-1);
+}
+
+//-------------------------------------------------------------------------------
+unsigned int vtkBSplineSurfaceSource::GetDegreeY() const
+{
+  return std::min(this->Degree[1], this->NumberOfControlPoints[1]-1);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::SetSpanResolution(unsigned int x, unsigned int y)
+{
+  x = std::max(x, 1u);
+  y = std::max(y, 1u);
+  if (this->SpanResolution[0] == x && this->SpanResolution[1] == y)
+    {
+    return;
+    }
+
+  this->SpanResolution[0] = x;
+  this->SpanResolution[1] = y;
+  this->StructureValid = false;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::GetSpanResolution(unsigned int *resolution) const
+{
+  resolution[0] = this->SpanResolution[0];
+  resolution[1] = this->SpanResolution[1];
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::GetGridResolution(unsigned int *resolution) const
+{
+  resolution[0] = (this->NumberOfControlPoints[0]-this->GetDegreeX())*this->SpanResolution[0]+1;
+  resolution[1] = (this->NumberOfControlPoints[1]-this->GetDegreeY())*this->SpanResolution[1]+1;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::ResetControlPoints()
+{
+  unsigned int m = this->NumberOfControlPoints[0];
+  unsigned int n = this->NumberOfControlPoints[1];
+
+  double distx = 1.0 / static_cast<double>(m-1);
+  double disty = 1.0 / static_cast<double>(n-1);
+
+  for (unsigned int i=0; i<m; i++)
+    {
+    for (unsigned int j=0; j<n; j++)
+      {
+      this->ControlPoints->SetPoint(i*n+j, -0.5 + i*distx, -0.5 + j*disty, 0.0);
+      }
+    }
+
+  this->ControlPoints->Modified();
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+int vtkBSplineSurfaceSource::RequestData(vtkInformation *vtkNotUsed(request),
+                                         vtkInformationVector **vtkNotUsed(inputVector),
+                                         vtkInformationVector *outputVector)
+{
+  vtkInformation *outputInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(outputInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!output)
+    {
+    return 1;
+    }
+
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+  const double *controlPoints =
+    vtkDoubleArray::SafeDownCast(this->ControlPoints->GetData())->GetPointer(0);
+  this->NumberOfEvaluatedPoints = 0;
+
+  if (!this->StructureValid ||
+      this->EvaluatedNormals != this->ComputeNormals ||
+      this->EvaluatedPrecision != this->OutputPointsPrecision)
+    {
+    this->UpdateStructure();
+    this->EvaluateGridRegion(0, this->GridResolution[0], 0, this->GridResolution[1]);
+    this->EvaluatedControlPoints.assign(controlPoints, controlPoints+xGrid*yGrid*3);
+    }
+  else
+    {
+    // Only the knot spans influenced by the moved control points are
+    // evaluated again, unless they cover most of the grid anyway
+    std::vector<unsigned int> movedControlPoints;
+    vtkIdType numberOfSamplesToEvaluate = 0;
+    for (unsigned int k=0; k<xGrid*yGrid; k++)
+      {
+      if (std::equal(controlPoints+k*3, controlPoints+k*3+3, &this->EvaluatedControlPoints[k*3]))
+        {
+        continue;
+        }
+
+      unsigned int i = k / yGrid;
+      unsigned int j = k % yGrid;
+      movedControlPoints.push_back(k);
+      numberOfSamplesToEvaluate +=
+        static_cast<vtkIdType>(this->LastInfluencedSample[0][i]-this->FirstInfluencedSample[0][i]+1)*
+        (this->LastInfluencedSample[1][j]-this->FirstInfluencedSample[1][j]+1);
+      }
+
+    if (numberOfSamplesToEvaluate >=
+        static_cast<vtkIdType>(this->GridResolution[0])*this->GridResolution[1])
+      {
+      this->EvaluateGridRegion(0, this->GridResolution[0], 0, this->GridResolution[1]);
+      }
+    else
+      {
+      for (unsigned int k : movedControlPoints)
+        {
+        unsigned int i = k / yGrid;
+        unsigned int j = k % yGrid;
+        this->EvaluateGridRegion(this->FirstInfluencedSample[0][i], this->LastInfluencedSample[0][i]+1,
+                                 this->FirstInfluencedSample[1][j], this->LastInfluencedSample[1][j]+1);
+        }
+      }
+
+    for (unsigned int k : movedControlPoints)
+      {
+      std::copy(controlPoints+k*3, controlPoints+k*3+3, &this->EvaluatedControlPoints[k*3]);
+      }
+    }
+
+  if (this->NumberOfEvaluatedPoints > 0)
+    {
+    this->DataArray->Modified();
+    if (this->ComputeNormals)
+      {
+      this->NormalsArray->Modified();
+      }
+    }
+
+  output->SetPoints(this->OutputPoints);
+  if (this->ComputeNormals)
+    {
+    output->GetPointData()->SetNormals(this->NormalsArray);
+    }
+  output->SetPolys(this->Topology);
+
+  return 1;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::UpdateStructure()
+{
+  unsigned int degree[2] = {this->GetDegreeX(), this->GetDegreeY()};
+  for (int d=0; d<2; d++)
+    {
+    BuildBSplineBasisTables(this->NumberOfControlPoints[d], degree[d], this->SpanResolution[d],
+                            this->FirstControlPoint[d], this->Basis[d], this->DerivativeBasis[d],
+                            this->FirstInfluencedSample[d], this->LastInfluencedSample[d]);
+    }
+
+  unsigned int gridResolution[2];
+  this->GetGridResolution(gridResolution);
+  bool resolutionChanged = gridResolution[0] != this->GridResolution[0] ||
+                           gridResolution[1] != this->GridResolution[1];
+  this->GridResolution[0] = gridResolution[0];
+  this->GridResolution[1] = gridResolution[1];
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(gridResolution[0])*gridResolution[1];
+
+  if (!this->DataArray || this->EvaluatedPrecision != this->OutputPointsPrecision)
+    {
+    // DEFAULT_PRECISION falls back to the precision of the control points
+    if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+      {
+      this->DataArray = vtkSmartPointer<vtkDataArray>::Take(vtkFloatArray::New());
+      this->NormalsArray = vtkSmartPointer<vtkDataArray>::Take(vtkFloatArray::New());
+      }
+    else
+      {
+      this->DataArray = vtkSmartPointer<vtkDataArray>::Take(vtkDoubleArray::New());
+      this->NormalsArray = vtkSmartPointer<vtkDataArray>::Take(vtkDoubleArray::New());
+      }
+    this->DataArray->SetNumberOfComponents(3);
+    this->NormalsArray->SetNumberOfComponents(3);
+    this->NormalsArray->SetName("Normals");
+    this->OutputPoints->SetData(this->DataArray);
+    }
+  this->DataArray->SetNumberOfTuples(numberOfPoints);
+  this->NormalsArray->SetNumberOfTuples(this->ComputeNormals ? numberOfPoints : 0);
+
+  if (resolutionChanged || !this->Topology)
+    {
+    this->Topology = BuildBSplineGridTopology(gridResolution[0], gridResolution[1]);
+    }
+
+  this->StructureValid = true;
+  this->EvaluatedNormals = this->ComputeNormals;
+  this->EvaluatedPrecision = this->OutputPointsPrecision;
+}
+
+//-------------------------------------------------------------------------------
+template <typename Real>
+void vtkBSplineSurfaceSource::EvaluateGridRegion(Real *points, Real *normals,
+                                                 unsigned int rowBegin, unsigned int rowEnd,
+                                                 unsigned int columnBegin, unsigned int columnEnd) const
+{
+  const unsigned int p = this->GetDegreeX();
+  const unsigned int q = this->GetDegreeY();
+  const unsigned int yGrid = this->NumberOfControlPoints[1];
+  const unsigned int yRes = this->GridResolution[1];
+  const double *controlPoints =
+    vtkDoubleArray::SafeDownCast(this->ControlPoints->GetData())->GetPointer(0);
+
+  // S = sum Nu(a) Nv(b) P(a,b) over the (p+1) x (q+1) control points of the
+  // knot span of every sample, with dS/du and dS/dv from the derivatives of
+  // the basis functions
+  auto evaluateRows = [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      const double *basisU = &this->Basis[0][i*(p+1)];
+      const double *derivativeBasisU = &this->DerivativeBasis[0][i*(p+1)];
+      unsigned int firstControlPointU = this->FirstControlPoint[0][i];
+
+      for (unsigned int j=columnBegin; j<columnEnd; j++)
+        {
+        const double *basisV = &this->Basis[1][j*(q+1)];
+        const double *derivativeBasisV = &this->DerivativeBasis[1][j*(q+1)];
+        unsigned int firstControlPointV = this->FirstControlPoint[1][j];
+
+        double point[3] = {0.0, 0.0, 0.0};
+        double derivativeU[3] = {0.0, 0.0, 0.0};
+        double derivativeV[3] = {0.0, 0.0, 0.0};
+        for (unsigned int a=0; a<=p; a++)
+          {
+          const double *controlPoint =
+            controlPoints+((firstControlPointU+a)*yGrid+firstControlPointV)*3;
+          double row[3] = {0.0, 0.0, 0.0};
+          double rowDerivative[3] = {0.0, 0.0, 0.0};
+          for (unsigned int b=0; b<=q; b++)
+            {
+            for (unsigned int c=0; c<3; c++)
+              {
+              row[c] += basisV[b] * controlPoint[b*3+c];
+              rowDerivative[c] += derivativeBasisV[b] * controlPoint[b*3+c];
+              }
+            }
+
+          for (unsigned int c=0; c<3; c++)
+            {
+            point[c] += basisU[a] * row[c];
+            derivativeU[c] += derivativeBasisU[a] * row[c];
+            derivativeV[c] += basisU[a] * rowDerivative[c];
+            }
+          }
+
+        Real *outputPoint = points+(i*yRes+j)*3;
+        outputPoint[0] = static_cast<Real>(point[0]);
+        outputPoint[1] = static_cast<Real>(point[1]);
+        outputPoint[2] = static_cast<Real>(point[2]);
+
+        if (normals)
+          {
+          double normal[3];
+          vtkMath::Cross(derivativeU, derivativeV, normal);
+          vtkMath::Normalize(normal);
+          Real *outputNormal = normals+(i*yRes+j)*3;
+          outputNormal[0] = static_cast<Real>(normal[0]);
+          outputNormal[1] = static_cast<Real>(normal[1]);
+          outputNormal[2] = static_cast<Real>(normal[2]);
+          }
+        }
+      }
+    };
+
+  vtkIdType numberOfSamples = static_cast<vtkIdType>(rowEnd-rowBegin)*(columnEnd-columnBegin);
+  if (numberOfSamples < BSplineParallelGrainSize)
+    {
+    evaluateRows(rowBegin, rowEnd);
+    }
+  else
+    {
+    vtkIdType grain = std::max<vtkIdType>(1, BSplineParallelGrainSize / (columnEnd-columnBegin));
+    vtkSMPTools::For(rowBegin, rowEnd, grain, evaluateRows);
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBSplineSurfaceSource::EvaluateGridRegion(unsigned int rowBegin, unsigned int rowEnd,
+                                                 unsigned int columnBegin, unsigned int columnEnd)
+{
+  if (auto floatPoints = vtkFloatArray::SafeDownCast(this->DataArray))
+    {
+    float *normals = this->ComputeNormals ?
+      vtkFloatArray::SafeDownCast(this->NormalsArray)->GetPointer(0) : nullptr;
+    this->EvaluateGridRegion(floatPoints->GetPointer(0), normals,
+                             rowBegin, rowEnd, columnBegin, columnEnd);
+    }
+  else
+    {
+    double *normals = this->ComputeNormals ?
+      vtkDoubleArray::SafeDownCast(this->NormalsArray)->GetPointer(0) : nullptr;
+    this->EvaluateGridRegion(vtkDoubleArray::SafeDownCast(this->DataArray)->GetPointer(0), normals,
+                             rowBegin, rowEnd, columnBegin, columnEnd);
+    }
+
+  this->NumberOfEvaluatedPoints +=
+    static_cast<vtkIdType>(rowEnd-rowBegin)*(columnEnd-columnBegin);
+}
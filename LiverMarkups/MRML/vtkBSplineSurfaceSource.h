@@ -0,0 +1,268 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkBSplineSurfaceSource_h
+#define __vtkBSplineSurfaceSource_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+//-------------------------------------------------------------------------------
+class vtkCellArray;
+class vtkDataArray;
+class vtkPoints;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class generates the geometry of a tensor-product B-spline
+ * surface of degree \f$p\times q\f$ over a net of \f$m\times n\f$ control
+ * points, with clamped uniform knot vectors (the surface interpolates the
+ * corners of the control net).
+ *
+ * Every control point only influences \f$(p+1)\times(q+1)\f$ knot spans, so
+ * the surface is sampled per knot span and a change of some control points
+ * only re-evaluates the samples of the spans they influence. The cost of an
+ * update after moving a control point is therefore independent of the size
+ * of the control net.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkBSplineSurfaceSource : public vtkPolyDataAlgorithm
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkBSplineSurfaceSource newly created.
+   */
+  static vtkBSplineSurfaceSource *New();
+
+  vtkTypeMacro(vtkBSplineSurfaceSource, vtkPolyDataAlgorithm);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set the control points, laid out row by row
+   * (\f$P_{00}, P_{01}, \ldots, P_{0n}, P_{10}, \ldots\f$). The positions are
+   * copied, and the source is only flagged as modified when some of them
+   * changed.
+   *
+   * @param points pointer to vtkPoints object containing at least
+   * \f$m\times n\f$ control points.
+   */
+  void SetControlPoints(vtkPoints *points);
+
+  /**
+   * Get the control points.
+   *
+   * @return control points, in double precision.
+   */
+  vtkPoints *GetControlPoints() const;
+
+  /**
+   * Set the number of control points in the parametric directions u and v.
+   * The degree in each direction is reduced if there are not enough control
+   * points for it, and the control points are reset to a plane of size 1.
+   *
+   * @param m number of control points in the parametric direction u.
+   * @param n number of control points in the parametric direction v.
+   */
+  void SetNumberOfControlPoints(unsigned int m, unsigned int n);
+
+  /**
+   * Get the number of control points in the parametric direction u.
+   */
+  unsigned int GetNumberOfControlPointsX() const
+  {return this->NumberOfControlPoints[0];}
+
+  /**
+   * Get the number of control points in the parametric direction v.
+   */
+  unsigned int GetNumberOfControlPointsY() const
+  {return this->NumberOfControlPoints[1];}
+
+  /**
+   * Set the degree of the surface in the parametric directions u and v
+   * (3 by default). The effective degree is at most the number of control
+   * points minus one.
+   *
+   * @param p degree in the parametric direction u.
+   * @param q degree in the parametric direction v.
+   */
+  void SetDegree(unsigned int p, unsigned int q);
+
+  /**
+   * Get the effective degree in the parametric direction u.
+   */
+  unsigned int GetDegreeX() const;
+
+  /**
+   * Get the effective degree in the parametric direction v.
+   */
+  unsigned int GetDegreeY() const;
+
+  /**
+   * Set the number of segments the surface is sampled with per knot span,
+   * in the parametric directions u and v.
+   *
+   * @param x number of segments per knot span along u.
+   * @param y number of segments per knot span along v.
+   */
+  void SetSpanResolution(unsigned int x, unsigned int y);
+
+  /**
+   * Get the number of segments per knot span.
+   *
+   * @param resolution pointer to int array containing u and v resolution.
+   */
+  void GetSpanResolution(unsigned int *resolution) const;
+
+  /**
+   * Get the number of samples of the output grid in each parametric
+   * direction.
+   *
+   * @param resolution pointer to int array containing u and v resolution.
+   */
+  void GetGridResolution(unsigned int *resolution) const;
+
+  /**
+   * Set the control points to the default values (e.g., lying in a
+   * plane of size 1).
+   */
+  void ResetControlPoints();
+
+  /**
+   * Set/Get whether exact per-vertex normals are computed from the analytic
+   * partial derivatives of the surface. Off by default.
+   */
+  vtkSetMacro(ComputeNormals, bool);
+  vtkGetMacro(ComputeNormals, bool);
+  vtkBooleanMacro(ComputeNormals, bool);
+
+  /**
+   * Set/get the desired precision for the output points and normals.
+   * vtkAlgorithm::SINGLE_PRECISION - Output single-precision floating point.
+   * vtkAlgorithm::DOUBLE_PRECISION - Output double-precision floating point.
+   * vtkAlgorithm::DEFAULT_PRECISION - Output double-precision floating point,
+   * the precision of the control points.
+   */
+  vtkSetMacro(OutputPointsPrecision, int);
+  vtkGetMacro(OutputPointsPrecision, int);
+
+  /**
+   * Get the number of grid samples evaluated by the last update. This is the
+   * whole grid after a change of the structure of the surface, and the
+   * samples of the knot spans influenced by the moved control points
+   * otherwise.
+   */
+  vtkGetMacro(NumberOfEvaluatedPoints, vtkIdType);
+
+ protected:
+  vtkBSplineSurfaceSource();
+  ~vtkBSplineSurfaceSource() override;
+
+  /**
+   * Function computing the B-spline surface according to the pipeline
+   * architecture of VTK.
+   *
+   * @return return code.
+   */
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+
+ private:
+  vtkBSplineSurfaceSource(const vtkBSplineSurfaceSource&);  // Not implemented.
+  void operator=(const vtkBSplineSurfaceSource&);  // Not implemented.
+
+  /**
+   * Rebuild the knot vectors, the basis tables of the grid samples, the
+   * output arrays and the topology after a change of the number of control
+   * points, the degree, the resolution or the output precision.
+   */
+  void UpdateStructure();
+
+  /**
+   * Evaluate the samples of the grid in the given range of rows and columns
+   * into the output arrays.
+   */
+  template <typename Real>
+  void EvaluateGridRegion(Real *points, Real *normals,
+                          unsigned int rowBegin, unsigned int rowEnd,
+                          unsigned int columnBegin, unsigned int columnEnd) const;
+  void EvaluateGridRegion(unsigned int rowBegin, unsigned int rowEnd,
+                          unsigned int columnBegin, unsigned int columnEnd);
+
+  unsigned int NumberOfControlPoints[2];
+  unsigned int Degree[2];                 // Requested degree
+  unsigned int SpanResolution[2];
+  unsigned int GridResolution[2];
+  bool ComputeNormals;
+  int OutputPointsPrecision;
+  vtkSmartPointer<vtkPoints> ControlPoints;
+  std::vector<double> EvaluatedControlPoints; // Control points of the current output
+  bool StructureValid;
+  bool EvaluatedNormals;
+  int EvaluatedPrecision;
+  vtkIdType NumberOfEvaluatedPoints;
+
+  // Per direction (u, v) basis tables: for every grid sample, the first
+  // control point of its knot span and the degree+1 non-zero basis
+  // functions and derivatives. For every control point, the first and last
+  // grid samples it influences.
+  std::vector<unsigned int> FirstControlPoint[2];
+  std::vector<double> Basis[2];
+  std::vector<double> DerivativeBasis[2];
+  std::vector<unsigned int> FirstInfluencedSample[2];
+  std::vector<unsigned int> LastInfluencedSample[2];
+
+  vtkSmartPointer<vtkPoints> OutputPoints;
+  vtkSmartPointer<vtkDataArray> DataArray;
+  vtkSmartPointer<vtkDataArray> NormalsArray;
+  vtkSmartPointer<vtkCellArray> Topology;
+};
+
+#endif
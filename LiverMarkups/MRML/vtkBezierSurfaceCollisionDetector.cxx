@@ -0,0 +1,897 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceCollisionDetector.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkBezierSurfaceCollisionDetector.h"
+#include "vtkBezierSurfaceSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Closest point to p on the triangle (a, b, c) (Ericson, Real-Time Collision
+// Detection, 5.1.5).
+void ClosestPointOnTriangle(const double p[3], const double a[3], const double b[3],
+                            const double c[3], double closest[3])
+{
+  double ab[3], ac[3], ap[3];
+  vtkMath::Subtract(b, a, ab);
+  vtkMath::Subtract(c, a, ac);
+  vtkMath::Subtract(p, a, ap);
+  double d1 = vtkMath::Dot(ab, ap);
+  double d2 = vtkMath::Dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+    {
+    std::copy(a, a+3, closest);
+    return;
+    }
+
+  double bp[3];
+  vtkMath::Subtract(p, b, bp);
+  double d3 = vtkMath::Dot(ab, bp);
+  double d4 = vtkMath::Dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3)
+    {
+    std::copy(b, b+3, closest);
+    return;
+    }
+
+  double vc = d1*d4 - d3*d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+    double v = (d1 != d3) ? d1/(d1 - d3) : 0.0;
+    for (int k=0; k<3; k++)
+      {
+      closest[k] = a[k] + v*ab[k];
+      }
+    return;
+    }
+
+  double cp[3];
+  vtkMath::Subtract(p, c, cp);
+  double d5 = vtkMath::Dot(ab, cp);
+  double d6 = vtkMath::Dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6)
+    {
+    std::copy(c, c+3, closest);
+    return;
+    }
+
+  double vb = d5*d2 - d1*d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+    double w = (d2 != d6) ? d2/(d2 - d6) : 0.0;
+    for (int k=0; k<3; k++)
+      {
+      closest[k] = a[k] + w*ac[k];
+      }
+    return;
+    }
+
+  double va = d3*d6 - d5*d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+    double w = (d4 - d3)/((d4 - d3) + (d5 - d6));
+    for (int k=0; k<3; k++)
+      {
+      closest[k] = b[k] + w*(c[k] - b[k]);
+      }
+    return;
+    }
+
+  // Degenerate triangles have no interior
+  double denominator = va + vb + vc;
+  double v = (denominator != 0.0) ? vb/denominator : 0.0;
+  double w = (denominator != 0.0) ? vc/denominator : 0.0;
+  for (int k=0; k<3; k++)
+    {
+    closest[k] = a[k] + v*ab[k] + w*ac[k];
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Squared distance between the segments (p1, q1) and (p2, q2) (Ericson,
+// Real-Time Collision Detection, 5.1.9).
+double SegmentSegmentDistance2(const double p1[3], const double q1[3],
+                               const double p2[3], const double q2[3])
+{
+  double d1[3], d2[3], r[3];
+  vtkMath::Subtract(q1, p1, d1);
+  vtkMath::Subtract(q2, p2, d2);
+  vtkMath::Subtract(p1, p2, r);
+  double a = vtkMath::Dot(d1, d1);
+  double e = vtkMath::Dot(d2, d2);
+  double f = vtkMath::Dot(d2, r);
+  const double epsilon = 1e-300;
+
+  double s = 0.0;
+  double t = 0.0;
+  if (a <= epsilon && e <= epsilon)
+    {
+    return vtkMath::Distance2BetweenPoints(p1, p2);
+    }
+  if (a <= epsilon)
+    {
+    t = std::min(1.0, std::max(0.0, f/e));
+    }
+  else
+    {
+    double c = vtkMath::Dot(d1, r);
+    if (e <= epsilon)
+      {
+      s = std::min(1.0, std::max(0.0, -c/a));
+      }
+    else
+      {
+      double b = vtkMath::Dot(d1, d2);
+      double denominator = a*e - b*b;
+      s = (denominator > 0.0) ? std::min(1.0, std::max(0.0, (b*f - c*e)/denominator)) : 0.0;
+      t = (b*s + f)/e;
+      if (t < 0.0)
+        {
+        t = 0.0;
+        s = std::min(1.0, std::max(0.0, -c/a));
+        }
+      else if (t > 1.0)
+        {
+        t = 1.0;
+        s = std::min(1.0, std::max(0.0, (b - c)/a));
+        }
+      }
+    }
+
+  double c1[3], c2[3];
+  for (int k=0; k<3; k++)
+    {
+    c1[k] = p1[k] + s*d1[k];
+    c2[k] = p2[k] + t*d2[k];
+    }
+  return vtkMath::Distance2BetweenPoints(c1, c2);
+}
+
+//-------------------------------------------------------------------------------
+// Squared distance between the segment (p, q) and the triangle (a, b, c).
+double SegmentTriangleDistance2(const double p[3], const double q[3],
+                                const double a[3], const double b[3], const double c[3])
+{
+  // The segment crosses the plane of the triangle inside the triangle
+  double ab[3], ac[3], normal[3];
+  vtkMath::Subtract(b, a, ab);
+  vtkMath::Subtract(c, a, ac);
+  vtkMath::Cross(ab, ac, normal);
+  double ap[3], aq[3];
+  vtkMath::Subtract(p, a, ap);
+  vtkMath::Subtract(q, a, aq);
+  double sp = vtkMath::Dot(normal, ap);
+  double sq = vtkMath::Dot(normal, aq);
+  if ((sp <= 0.0 && sq >= 0.0) || (sp >= 0.0 && sq <= 0.0))
+    {
+    if (sp != sq)
+      {
+      double t = sp/(sp - sq);
+      double x[3] = {p[0] + t*(q[0]-p[0]), p[1] + t*(q[1]-p[1]), p[2] + t*(q[2]-p[2])};
+      double closest[3];
+      ClosestPointOnTriangle(x, a, b, c, closest);
+      double scale = vtkMath::Dot(ab, ab) + vtkMath::Dot(ac, ac);
+      if (vtkMath::Distance2BetweenPoints(x, closest) <= 1e-24*scale)
+        {
+        return 0.0;
+        }
+      }
+    }
+
+  double closest[3];
+  ClosestPointOnTriangle(p, a, b, c, closest);
+  double distance2 = vtkMath::Distance2BetweenPoints(p, closest);
+  ClosestPointOnTriangle(q, a, b, c, closest);
+  distance2 = std::min(distance2, vtkMath::Distance2BetweenPoints(q, closest));
+  distance2 = std::min(distance2, SegmentSegmentDistance2(p, q, a, b));
+  distance2 = std::min(distance2, SegmentSegmentDistance2(p, q, b, c));
+  distance2 = std::min(distance2, SegmentSegmentDistance2(p, q, c, a));
+  return distance2;
+}
+
+//-------------------------------------------------------------------------------
+// Squared distance between two triangles, given as 9 coordinates each. The
+// closest points lie on an edge of one of the triangles.
+double TriangleTriangleDistance2(const double *t1, const double *t2)
+{
+  double distance2 = VTK_DOUBLE_MAX;
+  for (int e=0; e<3 && distance2 > 0.0; e++)
+    {
+    distance2 = std::min(distance2, SegmentTriangleDistance2(t1+3*e, t1+3*((e+1)%3),
+                                                             t2, t2+3, t2+6));
+    distance2 = std::min(distance2, SegmentTriangleDistance2(t2+3*e, t2+3*((e+1)%3),
+                                                             t1, t1+3, t1+6));
+    }
+  return distance2;
+}
+
+//-------------------------------------------------------------------------------
+double BoxBoxDistance(const double *bounds1, const double *bounds2)
+{
+  double distance2 = 0.0;
+  for (int k=0; k<3; k++)
+    {
+    double gap = std::max(bounds1[2*k] - bounds2[2*k+1], bounds2[2*k] - bounds1[2*k+1]);
+    if (gap > 0.0)
+      {
+      distance2 += gap*gap;
+      }
+    }
+  return std::sqrt(distance2);
+}
+
+//-------------------------------------------------------------------------------
+double BoxDiagonal2(const double *bounds)
+{
+  double diagonal2 = 0.0;
+  for (int k=0; k<3; k++)
+    {
+    diagonal2 += (bounds[2*k+1] - bounds[2*k])*(bounds[2*k+1] - bounds[2*k]);
+    }
+  return diagonal2;
+}
+
+//-------------------------------------------------------------------------------
+void ComputeBounds(const double *points, std::size_t numberOfPoints, double bounds[6])
+{
+  for (int k=0; k<3; k++)
+    {
+    bounds[2*k] = VTK_DOUBLE_MAX;
+    bounds[2*k+1] = VTK_DOUBLE_MIN;
+    }
+  for (std::size_t i=0; i<numberOfPoints; i++)
+    {
+    for (int k=0; k<3; k++)
+      {
+      bounds[2*k] = std::min(bounds[2*k], points[3*i+k]);
+      bounds[2*k+1] = std::max(bounds[2*k+1], points[3*i+k]);
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Bounding volume hierarchy over the triangles of a tumor mesh
+struct TumorHierarchyNode
+{
+  double Bounds[6];
+  int Children[2];     // -1 for leaves
+  std::size_t First;   // first triangle of a leaf
+  std::size_t Count;   // number of triangles of a leaf
+};
+
+struct TumorHierarchy
+{
+  vtkSmartPointer<vtkPolyData> Mesh;
+  vtkMTimeType BuildTime = 0;          // mesh modification time at the last build
+  std::vector<double> Triangles;       // 9 coordinates per triangle
+  std::vector<TumorHierarchyNode> Nodes;
+
+  void Build();
+
+private:
+  int BuildNode(std::vector<std::size_t> &order, const std::vector<double> &centers,
+                std::size_t first, std::size_t count, const std::vector<double> &triangles);
+};
+
+const std::size_t TumorHierarchyLeafSize = 4;
+
+//-------------------------------------------------------------------------------
+void TumorHierarchy::Build()
+{
+  this->Triangles.clear();
+  this->Nodes.clear();
+  this->BuildTime = this->Mesh->GetMTime();
+
+  vtkPoints *points = this->Mesh->GetPoints();
+  if (!points)
+    {
+    return;
+    }
+
+  // Polygons are split in fans and strips in consecutive triangles
+  std::vector<double> triangles;
+  auto insertTriangle = [&](vtkIdType i, vtkIdType j, vtkIdType k)
+    {
+    double p[3];
+    for (vtkIdType id : {i, j, k})
+      {
+      points->GetPoint(id, p);
+      triangles.insert(triangles.end(), p, p+3);
+      }
+    };
+  vtkIdType numberOfCellPoints;
+  const vtkIdType *cellPoints;
+  vtkCellArray *polys = this->Mesh->GetPolys();
+  for (vtkIdType c=0; polys && c<polys->GetNumberOfCells(); c++)
+    {
+    polys->GetCellAtId(c, numberOfCellPoints, cellPoints);
+    for (vtkIdType k=1; k+1<numberOfCellPoints; k++)
+      {
+      insertTriangle(cellPoints[0], cellPoints[k], cellPoints[k+1]);
+      }
+    }
+  vtkCellArray *strips = this->Mesh->GetStrips();
+  for (vtkIdType c=0; strips && c<strips->GetNumberOfCells(); c++)
+    {
+    strips->GetCellAtId(c, numberOfCellPoints, cellPoints);
+    for (vtkIdType k=0; k+2<numberOfCellPoints; k++)
+      {
+      insertTriangle(cellPoints[k], cellPoints[k+1], cellPoints[k+2]);
+      }
+    }
+
+  std::size_t numberOfTriangles = triangles.size()/9;
+  if (numberOfTriangles == 0)
+    {
+    return;
+    }
+
+  std::vector<double> centers(3*numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    for (int k=0; k<3; k++)
+      {
+      centers[3*t+k] = (triangles[9*t+k] + triangles[9*t+3+k] + triangles[9*t+6+k])/3.0;
+      }
+    }
+  std::vector<std::size_t> order(numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    order[t] = t;
+    }
+  this->Nodes.reserve(2*numberOfTriangles/TumorHierarchyLeafSize + 1);
+  this->BuildNode(order, centers, 0, numberOfTriangles, triangles);
+
+  // Triangles in the order of the leaves
+  this->Triangles.resize(triangles.size());
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    std::copy(&triangles[9*order[t]], &triangles[9*order[t]]+9, &this->Triangles[9*t]);
+    }
+}
+
+//-------------------------------------------------------------------------------
+int TumorHierarchy::BuildNode(std::vector<std::size_t> &order, const std::vector<double> &centers,
+                              std::size_t first, std::size_t count,
+                              const std::vector<double> &triangles)
+{
+  int index = static_cast<int>(this->Nodes.size());
+  this->Nodes.push_back(TumorHierarchyNode());
+  TumorHierarchyNode node;
+  double centerBounds[6];
+  for (int k=0; k<3; k++)
+    {
+    node.Bounds[2*k] = centerBounds[2*k] = VTK_DOUBLE_MAX;
+    node.Bounds[2*k+1] = centerBounds[2*k+1] = VTK_DOUBLE_MIN;
+    }
+  for (std::size_t t=first; t<first+count; t++)
+    {
+    double triangleBounds[6];
+    ComputeBounds(&triangles[9*order[t]], 3, triangleBounds);
+    for (int k=0; k<3; k++)
+      {
+      node.Bounds[2*k] = std::min(node.Bounds[2*k], triangleBounds[2*k]);
+      node.Bounds[2*k+1] = std::max(node.Bounds[2*k+1], triangleBounds[2*k+1]);
+      centerBounds[2*k] = std::min(centerBounds[2*k], centers[3*order[t]+k]);
+      centerBounds[2*k+1] = std::max(centerBounds[2*k+1], centers[3*order[t]+k]);
+      }
+    }
+  node.First = first;
+  node.Count = count;
+  node.Children[0] = node.Children[1] = -1;
+
+  if (count > TumorHierarchyLeafSize)
+    {
+    // Median split along the longest axis of the triangle centers
+    int axis = 0;
+    for (int k=1; k<3; k++)
+      {
+      if (centerBounds[2*k+1] - centerBounds[2*k] > centerBounds[2*axis+1] - centerBounds[2*axis])
+        {
+        axis = k;
+        }
+      }
+    std::size_t half = count/2;
+    std::nth_element(order.begin()+first, order.begin()+first+half, order.begin()+first+count,
+                     [&](std::size_t i, std::size_t j) {return centers[3*i+axis] < centers[3*j+axis];});
+    node.Children[0] = this->BuildNode(order, centers, first, half, triangles);
+    node.Children[1] = this->BuildNode(order, centers, first+half, count-half, triangles);
+    }
+
+  this->Nodes[index] = node;
+  return index;
+}
+
+//-------------------------------------------------------------------------------
+// Sub-patch of the surface, bounded by the box of its control points
+struct SurfacePatchNode
+{
+  double Bounds[6];
+  std::size_t Offset;  // first coefficient in the pool
+  int Children[2];     // -1 until the sub-patch is split
+  unsigned int Depth;
+  bool Leaf;           // flat enough to be compared as two triangles
+};
+
+//-------------------------------------------------------------------------------
+// Pair of a sub-patch and a hierarchy node, ordered by the lower bound of
+// their distance
+struct CollisionPair
+{
+  double LowerBound;
+  int Patch;
+  int Tumor;
+  int Node;
+
+  bool operator>(const CollisionPair &other) const
+  {return this->LowerBound > other.LowerBound;}
+};
+
+//-------------------------------------------------------------------------------
+// Largest distance of the inner control points of the curves of a sub-patch
+// to their chords.
+double ComputeBezierCurvesFlatness(const double *patch, unsigned int numberOfCurves,
+                                   unsigned int curveStride, unsigned int order,
+                                   unsigned int pointStride)
+{
+  double flatness = 0.0;
+  for (unsigned int c=0; c<numberOfCurves; c++)
+    {
+    const double *p0 = patch + c*curveStride;
+    const double *p1 = p0 + (order-1)*pointStride;
+    double chord[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+    double chordLength2 = vtkMath::Dot(chord, chord);
+    for (unsigned int k=1; k+1<order; k++)
+      {
+      const double *p = p0 + k*pointStride;
+      double d[3] = {p[0]-p0[0], p[1]-p0[1], p[2]-p0[2]};
+      double t = (chordLength2 > 0.0) ? vtkMath::Dot(d, chord)/chordLength2 : 0.0;
+      t = std::min(1.0, std::max(0.0, t));
+      double e[3] = {d[0]-t*chord[0], d[1]-t*chord[1], d[2]-t*chord[2]};
+      flatness = std::max(flatness, vtkMath::Norm(e));
+      }
+    }
+  return flatness;
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+class vtkBezierSurfaceCollisionDetector::vtkInternals
+{
+public:
+  std::vector<TumorHierarchy> Tumors;
+
+  // Sub-patches of the surface, refined lazily by the search
+  unsigned int NumberOfControlPoints[2] = {0, 0};
+  std::vector<SurfacePatchNode> Patches;
+  std::vector<double> Coefficients;
+  std::vector<double> Scratch;
+  vtkMTimeType SurfaceTime = 0;  // surface modification time of the search
+  vtkMTimeType DetectorTime = 0; // detector modification time of the search
+
+  std::priority_queue<CollisionPair, std::vector<CollisionPair>, std::greater<CollisionPair>> Queue;
+  double BestDistance = VTK_DOUBLE_MAX;
+  int BestTumor = -1;
+
+  int AddPatch(const double *coefficients, unsigned int depth, double tolerance,
+               unsigned int maximumDepth);
+  void SplitPatch(int index, double tolerance, unsigned int maximumDepth);
+  double LeafDistance(int patch, const TumorHierarchy &tumor, const TumorHierarchyNode &node);
+};
+
+//-------------------------------------------------------------------------------
+int vtkBezierSurfaceCollisionDetector::vtkInternals::AddPatch(const double *coefficients,
+                                                              unsigned int depth, double tolerance,
+                                                              unsigned int maximumDepth)
+{
+  unsigned int m = this->NumberOfControlPoints[0];
+  unsigned int n = this->NumberOfControlPoints[1];
+
+  SurfacePatchNode patch;
+  patch.Offset = this->Coefficients.size();
+  patch.Children[0] = patch.Children[1] = -1;
+  patch.Depth = depth;
+  ComputeBounds(coefficients, m*n, patch.Bounds);
+
+  // Flat sub-patches are within the tolerance of the two triangles of their
+  // corners
+  const double *p00 = coefficients;
+  const double *p10 = coefficients + 3*(m-1)*n;
+  const double *p01 = coefficients + 3*(n-1);
+  const double *p11 = coefficients + 3*((m-1)*n + n-1);
+  double twist[3];
+  for (int k=0; k<3; k++)
+    {
+    twist[k] = p00[k] - p10[k] - p01[k] + p11[k];
+    }
+  double flatness = std::max(ComputeBezierCurvesFlatness(coefficients, n, 3, m, 3*n),
+                             ComputeBezierCurvesFlatness(coefficients, m, 3*n, n, 3));
+  flatness = std::max(flatness, 0.25*vtkMath::Norm(twist));
+  patch.Leaf = (depth >= maximumDepth || flatness <= tolerance);
+
+  this->Coefficients.insert(this->Coefficients.end(), coefficients, coefficients + 3*m*n);
+  this->Patches.push_back(patch);
+  return static_cast<int>(this->Patches.size()) - 1;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::vtkInternals::SplitPatch(int index, double tolerance,
+                                                                 unsigned int maximumDepth)
+{
+  unsigned int m = this->NumberOfControlPoints[0];
+  unsigned int n = this->NumberOfControlPoints[1];
+
+  // Split along the parametric direction whose curves are least flat
+  const double *coefficients = &this->Coefficients[this->Patches[index].Offset];
+  double flatnessU = ComputeBezierCurvesFlatness(coefficients, n, 3, m, 3*n);
+  double flatnessV = ComputeBezierCurvesFlatness(coefficients, m, 3*n, n, 3);
+  int direction = (flatnessU >= flatnessV) ? 0 : 1;
+
+  unsigned int numberOfCurves = (direction == 0) ? n : m;
+  unsigned int order = (direction == 0) ? m : n;
+  unsigned int curveStride = (direction == 0) ? 3 : 3*n;
+  unsigned int pointStride = (direction == 0) ? 3*n : 3;
+
+  std::vector<double> left(3*m*n);
+  std::vector<double> right(3*m*n);
+  double *scratch = this->Scratch.data();
+  for (unsigned int c=0; c<numberOfCurves; c++)
+    {
+    const double *curve = coefficients + c*curveStride;
+    double *leftCurve = &left[c*curveStride];
+    double *rightCurve = &right[c*curveStride];
+    for (unsigned int k=0; k<order; k++)
+      {
+      std::copy(curve + k*pointStride, curve + k*pointStride + 3, scratch + 3*k);
+      }
+    std::copy(scratch, scratch+3, leftCurve);
+    std::copy(scratch + 3*(order-1), scratch + 3*order, rightCurve + (order-1)*pointStride);
+    for (unsigned int r=1; r<order; r++)
+      {
+      for (unsigned int k=0; k<3*(order-r); k++)
+        {
+        scratch[k] = 0.5*(scratch[k] + scratch[k+3]);
+        }
+      std::copy(scratch, scratch+3, leftCurve + r*pointStride);
+      std::copy(scratch + 3*(order-1-r), scratch + 3*(order-r), rightCurve + (order-1-r)*pointStride);
+      }
+    }
+
+  unsigned int depth = this->Patches[index].Depth + 1;
+  int leftIndex = this->AddPatch(left.data(), depth, tolerance, maximumDepth);
+  int rightIndex = this->AddPatch(right.data(), depth, tolerance, maximumDepth);
+  this->Patches[index].Children[0] = leftIndex;
+  this->Patches[index].Children[1] = rightIndex;
+}
+
+//-------------------------------------------------------------------------------
+double vtkBezierSurfaceCollisionDetector::vtkInternals::LeafDistance(int patch,
+                                                                     const TumorHierarchy &tumor,
+                                                                     const TumorHierarchyNode &node)
+{
+  unsigned int m = this->NumberOfControlPoints[0];
+  unsigned int n = this->NumberOfControlPoints[1];
+  const double *coefficients = &this->Coefficients[this->Patches[patch].Offset];
+  const double *p00 = coefficients;
+  const double *p10 = coefficients + 3*(m-1)*n;
+  const double *p01 = coefficients + 3*(n-1);
+  const double *p11 = coefficients + 3*((m-1)*n + n-1);
+  double quad[2][9];
+  for (int k=0; k<3; k++)
+    {
+    quad[0][k] = p00[k]; quad[0][3+k] = p10[k]; quad[0][6+k] = p11[k];
+    quad[1][k] = p00[k]; quad[1][3+k] = p11[k]; quad[1][6+k] = p01[k];
+    }
+
+  double distance2 = VTK_DOUBLE_MAX;
+  for (std::size_t t=node.First; t<node.First+node.Count && distance2 > 0.0; t++)
+    {
+    const double *triangle = &tumor.Triangles[9*t];
+    distance2 = std::min(distance2, TriangleTriangleDistance2(quad[0], triangle));
+    distance2 = std::min(distance2, TriangleTriangleDistance2(quad[1], triangle));
+    }
+  return std::sqrt(distance2);
+}
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBezierSurfaceCollisionDetector);
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceCollisionDetector::vtkBezierSurfaceCollisionDetector()
+{
+  this->Internals = new vtkInternals;
+  this->Tolerance = 0.1;
+  this->MaximumSubdivisionDepth = 16;
+  this->TimeBudget = 5.0;
+  this->Intersecting = false;
+  this->MinimumClearance = VTK_DOUBLE_MAX;
+  this->ClearanceLowerBound = 0.0;
+  this->ClosestTumor = -1;
+  this->QueryComplete = false;
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceCollisionDetector::~vtkBezierSurfaceCollisionDetector()
+{
+  delete this->Internals;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Surface: " << this->Surface.GetPointer() << "\n";
+  os << indent << "Number Of Tumors: " << this->GetNumberOfTumors() << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Maximum Subdivision Depth: " << this->MaximumSubdivisionDepth << "\n";
+  os << indent << "Time Budget: " << this->TimeBudget << "\n";
+  os << indent << "Intersecting: " << this->Intersecting << "\n";
+  os << indent << "Minimum Clearance: " << this->MinimumClearance << "\n";
+  os << indent << "Clearance Lower Bound: " << this->ClearanceLowerBound << "\n";
+  os << indent << "Closest Tumor: " << this->ClosestTumor << "\n";
+  os << indent << "Query Complete: " << this->QueryComplete << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::SetSurface(vtkBezierSurfaceSource *surface)
+{
+  if (this->Surface == surface)
+    {
+    return;
+    }
+
+  this->Surface = surface;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceSource *vtkBezierSurfaceCollisionDetector::GetSurface() const
+{
+  return this->Surface;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::AddTumor(vtkPolyData *tumor)
+{
+  if (!tumor)
+    {
+    return;
+    }
+
+  TumorHierarchy hierarchy;
+  hierarchy.Mesh = tumor;
+  this->Internals->Tumors.push_back(hierarchy);
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::RemoveAllTumors()
+{
+  if (this->Internals->Tumors.empty())
+    {
+    return;
+    }
+
+  this->Internals->Tumors.clear();
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+int vtkBezierSurfaceCollisionDetector::GetNumberOfTumors() const
+{
+  return static_cast<int>(this->Internals->Tumors.size());
+}
+
+//-------------------------------------------------------------------------------
+vtkPolyData *vtkBezierSurfaceCollisionDetector::GetTumor(int index) const
+{
+  if (index < 0 || index >= this->GetNumberOfTumors())
+    {
+    return nullptr;
+    }
+  return this->Internals->Tumors[index].Mesh;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceCollisionDetector::UpdateSearch()
+{
+  vtkInternals *internals = this->Internals;
+
+  // Changes of the tumors, of the settings or of the surface restart the
+  // search; the hierarchies are only rebuilt for modified tumors
+  bool restart = internals->DetectorTime != this->GetMTime() ||
+    internals->SurfaceTime != this->Surface->GetMTime();
+  for (TumorHierarchy &tumor : internals->Tumors)
+    {
+    if (tumor.BuildTime != tumor.Mesh->GetMTime())
+      {
+      tumor.Build();
+      restart = true;
+      }
+    }
+  if (!restart)
+    {
+    return;
+    }
+
+  // Root sub-patch: the control net of the surface
+  unsigned int m = this->Surface->GetNumberOfControlPointsX();
+  unsigned int n = this->Surface->GetNumberOfControlPointsY();
+  internals->NumberOfControlPoints[0] = m;
+  internals->NumberOfControlPoints[1] = n;
+  internals->Scratch.resize(3*std::max(m, n));
+  internals->Patches.clear();
+  internals->Coefficients.clear();
+  std::vector<double> controlNet(3*m*n);
+  vtkSmartPointer<vtkPoints> controlPoints = this->Surface->GetControlPoints();
+  for (unsigned int k=0; k<m*n; k++)
+    {
+    controlPoints->GetPoint(k, &controlNet[3*k]);
+    }
+  internals->AddPatch(controlNet.data(), 0, this->Tolerance, this->MaximumSubdivisionDepth);
+
+  internals->Queue = decltype(internals->Queue)();
+  for (int t=0; t<static_cast<int>(internals->Tumors.size()); t++)
+    {
+    const TumorHierarchy &tumor = internals->Tumors[t];
+    if (!tumor.Nodes.empty())
+      {
+      double lowerBound = BoxBoxDistance(internals->Patches[0].Bounds, tumor.Nodes[0].Bounds);
+      internals->Queue.push({lowerBound, 0, t, 0});
+      }
+    }
+  internals->BestDistance = VTK_DOUBLE_MAX;
+  internals->BestTumor = -1;
+  internals->SurfaceTime = this->Surface->GetMTime();
+  internals->DetectorTime = this->GetMTime();
+}
+
+//-------------------------------------------------------------------------------
+bool vtkBezierSurfaceCollisionDetector::CheckCollisions()
+{
+  if (!this->Surface)
+    {
+    vtkErrorMacro("CheckCollisions: no surface.");
+    return false;
+    }
+
+  auto start = std::chrono::steady_clock::now();
+  this->UpdateSearch();
+
+  vtkInternals *internals = this->Internals;
+  auto &queue = internals->Queue;
+  double tolerance = this->Tolerance;
+  unsigned int maximumDepth = this->MaximumSubdivisionDepth;
+  unsigned int iterations = 0;
+  bool outOfTime = false;
+  // Pairs closer than the best clearance by less than the tolerance cannot
+  // improve it beyond the accuracy of the flat sub-patches
+  while (!queue.empty() && queue.top().LowerBound < internals->BestDistance - tolerance)
+    {
+    // Check the time budget every few refinements
+    if (this->TimeBudget > 0.0 && (++iterations % 32) == 0)
+      {
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      if (elapsed.count() > this->TimeBudget)
+        {
+        outOfTime = true;
+        break;
+        }
+      }
+
+    CollisionPair pair = queue.top();
+    queue.pop();
+    const TumorHierarchy &tumor = internals->Tumors[pair.Tumor];
+    const TumorHierarchyNode &node = tumor.Nodes[pair.Node];
+    bool patchLeaf = internals->Patches[pair.Patch].Leaf;
+    bool nodeLeaf = (node.Children[0] < 0);
+
+    if (patchLeaf && nodeLeaf)
+      {
+      double distance = internals->LeafDistance(pair.Patch, tumor, node);
+      if (distance < internals->BestDistance)
+        {
+        internals->BestDistance = distance;
+        internals->BestTumor = pair.Tumor;
+        }
+      continue;
+      }
+
+    // Refine the larger of the two volumes
+    bool splitPatch = !patchLeaf &&
+      (nodeLeaf || BoxDiagonal2(internals->Patches[pair.Patch].Bounds) >= BoxDiagonal2(node.Bounds));
+    if (splitPatch)
+      {
+      if (internals->Patches[pair.Patch].Children[0] < 0)
+        {
+        internals->SplitPatch(pair.Patch, tolerance, maximumDepth);
+        }
+      for (int c=0; c<2; c++)
+        {
+        int child = internals->Patches[pair.Patch].Children[c];
+        double lowerBound = BoxBoxDistance(internals->Patches[child].Bounds, node.Bounds);
+        if (lowerBound < internals->BestDistance)
+          {
+          queue.push({lowerBound, child, pair.Tumor, pair.Node});
+          }
+        }
+      }
+    else
+      {
+      for (int c=0; c<2; c++)
+        {
+        int child = node.Children[c];
+        double lowerBound = BoxBoxDistance(internals->Patches[pair.Patch].Bounds, tumor.Nodes[child].Bounds);
+        if (lowerBound < internals->BestDistance)
+          {
+          queue.push({lowerBound, pair.Patch, pair.Tumor, child});
+          }
+        }
+      }
+    }
+
+  // The distances of flat sub-patches are within the tolerance of the
+  // distances of the surface
+  this->QueryComplete = !outOfTime;
+  this->MinimumClearance = internals->BestDistance;
+  this->ClosestTumor = internals->BestTumor;
+  this->Intersecting = (internals->BestDistance <= tolerance);
+  double lowerBound = internals->BestDistance - tolerance;
+  if (!queue.empty())
+    {
+    lowerBound = std::min(lowerBound, queue.top().LowerBound);
+    }
+  this->ClearanceLowerBound = std::max(0.0, lowerBound);
+
+  return this->Intersecting;
+}
@@ -0,0 +1,194 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceCollisionDetector.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkBezierSurfaceCollisionDetector_h
+#define __vtkBezierSurfaceCollisionDetector_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+//-------------------------------------------------------------------------------
+class vtkBezierSurfaceSource;
+class vtkPolyData;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class detects collisions between the Bézier surface defined by
+ * a vtkBezierSurfaceSource and a set of tumor meshes, and computes the
+ * minimum clearance between them.
+ *
+ * The query is a best-first branch and bound search over pairs of a
+ * sub-patch of the surface and a node of a bounding volume hierarchy built
+ * over the triangles of a tumor. Sub-patches are obtained by recursive
+ * subdivision of the control net and bounded by the box of their control
+ * points, which contains them (convex hull property). The pair with the
+ * smallest lower bound of the distance is refined first, until the lower
+ * bound reaches the clearance found so far. Sub-patches whose control net is
+ * flat within Tolerance are compared with the triangles as two triangles, so
+ * the clearance is accurate to the tolerance.
+ *
+ * The hierarchies are only rebuilt when a tumor mesh changes. A query stops
+ * when it exceeds its time budget, which keeps it within an interactive frame
+ * while control points are dragged; the result then holds the best clearance
+ * found so far and a lower bound of the exact clearance, and the next query
+ * resumes the search if neither the surface nor the tumors changed. A surface
+ * lying entirely inside a tumor, without crossing its boundary, is not
+ * reported as intersecting.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkBezierSurfaceCollisionDetector : public vtkObject
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkBezierSurfaceCollisionDetector newly created.
+   */
+  static vtkBezierSurfaceCollisionDetector *New();
+
+  vtkTypeMacro(vtkBezierSurfaceCollisionDetector, vtkObject);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set/get the surface checked for collisions. The control points of the
+   * surface are used as they are, without updating its pipeline.
+   */
+  void SetSurface(vtkBezierSurfaceSource *surface);
+  vtkBezierSurfaceSource *GetSurface() const;
+
+  /**
+   * Add/remove the tumor meshes. Polygons and triangle strips are used.
+   */
+  void AddTumor(vtkPolyData *tumor);
+  void RemoveAllTumors();
+  int GetNumberOfTumors() const;
+  vtkPolyData *GetTumor(int index) const;
+
+  /**
+   * Set/get the accuracy, in world units, of the clearance.
+   */
+  vtkSetClampMacro(Tolerance, double, 1e-6, VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance, double);
+
+  /**
+   * Set/get the maximum number of subdivisions of a sub-patch.
+   */
+  vtkSetClampMacro(MaximumSubdivisionDepth, unsigned int, 0, 40);
+  vtkGetMacro(MaximumSubdivisionDepth, unsigned int);
+
+  /**
+   * Set/get the time budget of a query, in milliseconds. A budget of 0 runs
+   * every query to completion.
+   */
+  vtkSetClampMacro(TimeBudget, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(TimeBudget, double);
+
+  /**
+   * Run (or resume) the collision query.
+   *
+   * @return true if the surface intersects a tumor (see GetIntersecting).
+   */
+  bool CheckCollisions();
+
+  /**
+   * Get whether the surface intersects a tumor, or comes closer to it than
+   * Tolerance, as found by the last query.
+   */
+  vtkGetMacro(Intersecting, bool);
+
+  /**
+   * Get the smallest distance between the surface and the tumors found by
+   * the last query (VTK_DOUBLE_MAX if there are no tumors).
+   */
+  vtkGetMacro(MinimumClearance, double);
+
+  /**
+   * Get a lower bound of the exact clearance. It is within Tolerance of the
+   * minimum clearance when the last query completed.
+   */
+  vtkGetMacro(ClearanceLowerBound, double);
+
+  /**
+   * Get the index of the tumor closest to the surface (-1 if unknown).
+   */
+  vtkGetMacro(ClosestTumor, int);
+
+  /**
+   * Get whether the last query completed within its time budget.
+   */
+  vtkGetMacro(QueryComplete, bool);
+
+ protected:
+  vtkBezierSurfaceCollisionDetector();
+  ~vtkBezierSurfaceCollisionDetector() override;
+
+ private:
+  vtkBezierSurfaceCollisionDetector(const vtkBezierSurfaceCollisionDetector&);  // Not implemented.
+  void operator=(const vtkBezierSurfaceCollisionDetector&);  // Not implemented.
+
+  /**
+   * Rebuild the hierarchies of the modified tumors and restart the search if
+   * the surface or the tumors changed since the last query.
+   */
+  void UpdateSearch();
+
+  class vtkInternals;
+  vtkInternals *Internals;
+
+  vtkSmartPointer<vtkBezierSurfaceSource> Surface;
+  double Tolerance;
+  unsigned int MaximumSubdivisionDepth;
+  double TimeBudget;
+
+  bool Intersecting;
+  double MinimumClearance;
+  double ClearanceLowerBound;
+  int ClosestTumor;
+  bool QueryComplete;
+};
+
+#endif
@@ -0,0 +1,677 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfacePlaneCutter.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkBezierSurfacePlaneCutter.h"
+#include "vtkBezierSurfaceSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Sub-patches store, for every control point, its coordinates and its signed
+// distance to the plane. The distance of the surface to the plane is the
+// Bezier patch of the signed distances, so both are subdivided together.
+const unsigned int BezierCutComponents = 4;
+
+//-------------------------------------------------------------------------------
+// Evaluate the scalar Bezier curve of the given order, whose coefficients are
+// stride values apart, at t.
+double EvaluateBezierCurve(const double *coefficients, unsigned int stride,
+                           unsigned int order, double t, double *scratch)
+{
+  for (unsigned int k=0; k<order; k++)
+    {
+    scratch[k] = coefficients[k*stride];
+    }
+  for (unsigned int r=1; r<order; r++)
+    {
+    for (unsigned int k=0; k<order-r; k++)
+      {
+      scratch[k] = (1-t)*scratch[k] + t*scratch[k+1];
+      }
+    }
+  return scratch[0];
+}
+
+//-------------------------------------------------------------------------------
+// Root in [0, 1] of a scalar Bezier curve whose end coefficients have
+// different signs (regula falsi with the Illinois modification).
+double FindBezierCurveRoot(const double *coefficients, unsigned int stride,
+                           unsigned int order, double *scratch)
+{
+  double a = 0.0;
+  double b = 1.0;
+  double fa = coefficients[0];
+  double fb = coefficients[(order-1)*stride];
+  double t = 0.0;
+  int side = 0;
+  for (int iteration=0; iteration<100; iteration++)
+    {
+    t = (fa*b - fb*a)/(fa - fb);
+    if (b - a < 1e-14)
+      {
+      break;
+      }
+    double ft = EvaluateBezierCurve(coefficients, stride, order, t, scratch);
+    if (ft == 0.0)
+      {
+      break;
+      }
+    if ((ft >= 0.0) == (fb >= 0.0))
+      {
+      b = t;
+      fb = ft;
+      if (side == -1)
+        {
+        fa *= 0.5;
+        }
+      side = -1;
+      }
+    else
+      {
+      a = t;
+      fa = ft;
+      if (side == 1)
+        {
+        fb *= 0.5;
+        }
+      side = 1;
+      }
+    }
+  return std::min(1.0, std::max(0.0, t));
+}
+
+//-------------------------------------------------------------------------------
+// Largest distance of the inner control points of the (x, y, z) curves of a
+// sub-patch to their chords.
+double ComputeBezierCurvesFlatness(const double *patch, unsigned int numberOfCurves,
+                                   unsigned int curveStride, unsigned int order,
+                                   unsigned int pointStride)
+{
+  double flatness = 0.0;
+  for (unsigned int c=0; c<numberOfCurves; c++)
+    {
+    const double *p0 = patch + c*curveStride;
+    const double *p1 = p0 + (order-1)*pointStride;
+    double chord[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+    double chordLength2 = vtkMath::Dot(chord, chord);
+    for (unsigned int k=1; k+1<order; k++)
+      {
+      const double *p = p0 + k*pointStride;
+      double d[3] = {p[0]-p0[0], p[1]-p0[1], p[2]-p0[2]};
+      double t = (chordLength2 > 0.0) ? vtkMath::Dot(d, chord)/chordLength2 : 0.0;
+      t = std::min(1.0, std::max(0.0, t));
+      double e[3] = {d[0]-t*chord[0], d[1]-t*chord[1], d[2]-t*chord[2]};
+      flatness = std::max(flatness, vtkMath::Norm(e));
+      }
+    }
+  return flatness;
+}
+
+//-------------------------------------------------------------------------------
+// Largest deviation of the signed distances of the curves of a sub-patch
+// from the linear interpolation of their end values.
+double ComputeBezierDistanceNonlinearity(const double *patch, unsigned int numberOfCurves,
+                                         unsigned int curveStride, unsigned int order,
+                                         unsigned int pointStride)
+{
+  double nonlinearity = 0.0;
+  for (unsigned int c=0; c<numberOfCurves; c++)
+    {
+    const double *d = patch + c*curveStride + 3;
+    double d0 = d[0];
+    double d1 = d[(order-1)*pointStride];
+    for (unsigned int k=1; k+1<order; k++)
+      {
+      double t = static_cast<double>(k)/(order-1);
+      nonlinearity = std::max(nonlinearity, std::fabs(d[k*pointStride] - ((1-t)*d0 + t*d1)));
+      }
+    }
+  return nonlinearity;
+}
+
+//-------------------------------------------------------------------------------
+class BezierSurfacePlaneCut
+{
+public:
+  BezierSurfacePlaneCut(unsigned int m, unsigned int n, double tolerance,
+                        unsigned int maximumDepth)
+    : M(m), N(n), Tolerance(tolerance), MaximumDepth(maximumDepth)
+  {
+    unsigned int patchSize = m*n*BezierCutComponents;
+    this->Children.resize(2*patchSize*(maximumDepth+1));
+    this->Scratch.resize(std::max(m, n)*BezierCutComponents);
+  }
+
+  void Subdivide(const double *patch, double u0, double u1, double v0, double v1,
+                 unsigned int depth);
+
+  std::vector<double> Parameters;  // (u, v) of the crossings
+  std::vector<vtkIdType> Segments; // pairs of crossings
+
+private:
+  void SplitPatch(const double *patch, int direction, double *left, double *right);
+  void IntersectPatch(const double *patch, double u0, double u1, double v0, double v1);
+  vtkIdType InsertCrossing(double u, double v);
+
+  const double *Value(const double *patch, unsigned int i, unsigned int j) const
+  {return patch + (i*this->N+j)*BezierCutComponents;}
+
+  unsigned int M;
+  unsigned int N;
+  double Tolerance;
+  unsigned int MaximumDepth;
+  std::vector<double> Children; // two sub-patches per subdivision level
+  std::vector<double> Scratch;
+  std::map<std::pair<long long, long long>, vtkIdType> Crossings;
+};
+
+//-------------------------------------------------------------------------------
+void BezierSurfacePlaneCut::Subdivide(const double *patch, double u0, double u1,
+                                      double v0, double v1, unsigned int depth)
+{
+  // Convex hull rejection: the sub-patch does not cross the plane if all
+  // the signed distances of its control points have the same sign
+  unsigned int numberOfControlPoints = this->M*this->N;
+  double minimumDistance = VTK_DOUBLE_MAX;
+  double maximumDistance = VTK_DOUBLE_MIN;
+  for (unsigned int k=0; k<numberOfControlPoints; k++)
+    {
+    double distance = patch[k*BezierCutComponents+3];
+    minimumDistance = std::min(minimumDistance, distance);
+    maximumDistance = std::max(maximumDistance, distance);
+    }
+  if (minimumDistance >= 0.0 || maximumDistance < 0.0)
+    {
+    return;
+    }
+
+  // Flatness of the curves along u and v, and twist of the corners
+  unsigned int componentsN = this->N*BezierCutComponents;
+  double flatnessU = ComputeBezierCurvesFlatness(patch, this->N, BezierCutComponents,
+                                                 this->M, componentsN);
+  double flatnessV = ComputeBezierCurvesFlatness(patch, this->M, componentsN,
+                                                 this->N, BezierCutComponents);
+  const double *p00 = this->Value(patch, 0, 0);
+  const double *p10 = this->Value(patch, this->M-1, 0);
+  const double *p01 = this->Value(patch, 0, this->N-1);
+  const double *p11 = this->Value(patch, this->M-1, this->N-1);
+  double twist[4];
+  for (unsigned int c=0; c<BezierCutComponents; c++)
+    {
+    twist[c] = p00[c] - p10[c] - p01[c] + p11[c];
+    }
+  double twistFlatness = 0.25*vtkMath::Norm(twist);
+
+  // A flat sub-patch may still be cut at a grazing angle, where a small
+  // deviation of the signed distance from a linear function moves the
+  // intersection a lot: the deviation is divided by the slope of the
+  // distance across the sub-patch to get the error of the intersection.
+  double nonlinearityU = ComputeBezierDistanceNonlinearity(patch, this->N, BezierCutComponents,
+                                                           this->M, componentsN);
+  double nonlinearityV = ComputeBezierDistanceNonlinearity(patch, this->M, componentsN,
+                                                           this->N, BezierCutComponents);
+  double minimumCorner = std::min(std::min(p00[3], p10[3]), std::min(p01[3], p11[3]));
+  double maximumCorner = std::max(std::max(p00[3], p10[3]), std::max(p01[3], p11[3]));
+  double diagonal = std::sqrt(std::max(vtkMath::Distance2BetweenPoints(p00, p11),
+                                       vtkMath::Distance2BetweenPoints(p10, p01)));
+  double slope = (diagonal > 0.0) ? (maximumCorner - minimumCorner)/diagonal : 0.0;
+  double errorU = flatnessU;
+  double errorV = flatnessV;
+  double twistError = twistFlatness;
+  if (slope > 0.0)
+    {
+    errorU = std::max(errorU, nonlinearityU/slope);
+    errorV = std::max(errorV, nonlinearityV/slope);
+    twistError = std::max(twistError, 0.25*std::fabs(twist[3])/slope);
+    }
+  else if (nonlinearityU > 0.0 || nonlinearityV > 0.0 || twist[3] != 0.0)
+    {
+    errorU = errorV = VTK_DOUBLE_MAX;
+    }
+
+  double tolerance = this->Tolerance;
+  if (depth >= this->MaximumDepth ||
+      (errorU <= tolerance && errorV <= tolerance && twistError <= tolerance))
+    {
+    this->IntersectPatch(patch, u0, u1, v0, v1);
+    return;
+    }
+
+  int direction = 0;
+  if (errorU <= tolerance && errorV <= tolerance)
+    {
+    direction = (u1 - u0 >= v1 - v0) ? 0 : 1;
+    }
+  else
+    {
+    direction = (errorU >= errorV) ? 0 : 1;
+    }
+
+  unsigned int patchSize = numberOfControlPoints*BezierCutComponents;
+  double *left = &this->Children[2*patchSize*depth];
+  double *right = left + patchSize;
+  this->SplitPatch(patch, direction, left, right);
+  if (direction == 0)
+    {
+    double u = 0.5*(u0 + u1);
+    this->Subdivide(left, u0, u, v0, v1, depth+1);
+    this->Subdivide(right, u, u1, v0, v1, depth+1);
+    }
+  else
+    {
+    double v = 0.5*(v0 + v1);
+    this->Subdivide(left, u0, u1, v0, v, depth+1);
+    this->Subdivide(right, u0, u1, v, v1, depth+1);
+    }
+}
+
+//-------------------------------------------------------------------------------
+void BezierSurfacePlaneCut::SplitPatch(const double *patch, int direction,
+                                       double *left, double *right)
+{
+  // Curves along the split direction, split at their middle with the de
+  // Casteljau algorithm
+  unsigned int numberOfCurves = (direction == 0) ? this->N : this->M;
+  unsigned int order = (direction == 0) ? this->M : this->N;
+  unsigned int curveStride = ((direction == 0) ? 1 : this->N)*BezierCutComponents;
+  unsigned int pointStride = ((direction == 0) ? this->N : 1)*BezierCutComponents;
+  double *scratch = this->Scratch.data();
+
+  for (unsigned int c=0; c<numberOfCurves; c++)
+    {
+    const double *curve = patch + c*curveStride;
+    double *leftCurve = left + c*curveStride;
+    double *rightCurve = right + c*curveStride;
+    for (unsigned int k=0; k<order; k++)
+      {
+      std::copy(curve + k*pointStride, curve + k*pointStride + BezierCutComponents,
+                scratch + k*BezierCutComponents);
+      }
+    std::copy(scratch, scratch + BezierCutComponents, leftCurve);
+    std::copy(scratch + (order-1)*BezierCutComponents, scratch + order*BezierCutComponents,
+              rightCurve + (order-1)*pointStride);
+    for (unsigned int r=1; r<order; r++)
+      {
+      for (unsigned int k=0; k<order-r; k++)
+        {
+        for (unsigned int i=0; i<BezierCutComponents; i++)
+          {
+          scratch[k*BezierCutComponents+i] =
+            0.5*(scratch[k*BezierCutComponents+i] + scratch[(k+1)*BezierCutComponents+i]);
+          }
+        }
+      std::copy(scratch, scratch + BezierCutComponents, leftCurve + r*pointStride);
+      std::copy(scratch + (order-1-r)*BezierCutComponents, scratch + (order-r)*BezierCutComponents,
+                rightCurve + (order-1-r)*pointStride);
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+void BezierSurfacePlaneCut::IntersectPatch(const double *patch, double u0, double u1,
+                                           double v0, double v1)
+{
+  // Boundary curves counterclockwise from (u0, v0): first control point,
+  // stride between control points, and parameter range
+  unsigned int m = this->M;
+  unsigned int n = this->N;
+  const double *edgeStart[4] = {this->Value(patch, 0, 0), this->Value(patch, m-1, 0),
+                                this->Value(patch, 0, n-1), this->Value(patch, 0, 0)};
+  const unsigned int edgeStride[4] = {n*BezierCutComponents, BezierCutComponents,
+                                      n*BezierCutComponents, BezierCutComponents};
+  const unsigned int edgeOrder[4] = {m, n, m, n};
+  const double edgeOrigin[4][2] = {{u0, v0}, {u1, v0}, {u0, v1}, {u0, v0}};
+  const double edgeVector[4][2] = {{u1-u0, 0.0}, {0.0, v1-v0}, {u1-u0, 0.0}, {0.0, v1-v0}};
+
+  // Corner distances are exact values of the surface
+  double corners[4] = {this->Value(patch, 0, 0)[3], this->Value(patch, m-1, 0)[3],
+                       this->Value(patch, m-1, n-1)[3], this->Value(patch, 0, n-1)[3]};
+
+  vtkIdType crossings[4] = {-1, -1, -1, -1};
+  int numberOfCrossings = 0;
+  double *scratch = this->Scratch.data();
+  for (int e=0; e<4; e++)
+    {
+    if ((corners[e] >= 0.0) == (corners[(e+1)%4] >= 0.0))
+      {
+      continue;
+      }
+    const double *distances = edgeStart[e] + 3;
+    double t = FindBezierCurveRoot(distances, edgeStride[e], edgeOrder[e], scratch);
+    crossings[e] = this->InsertCrossing(edgeOrigin[e][0] + t*edgeVector[e][0],
+                                        edgeOrigin[e][1] + t*edgeVector[e][1]);
+    numberOfCrossings++;
+    }
+
+  if (numberOfCrossings == 2)
+    {
+    vtkIdType ends[2];
+    int k = 0;
+    for (int e=0; e<4; e++)
+      {
+      if (crossings[e] >= 0)
+        {
+        ends[k++] = crossings[e];
+        }
+      }
+    if (ends[0] != ends[1])
+      {
+      this->Segments.push_back(ends[0]);
+      this->Segments.push_back(ends[1]);
+      }
+    }
+  else if (numberOfCrossings == 4)
+    {
+    // Saddle: the distance at the center tells which corners are connected
+    for (unsigned int i=0; i<m; i++)
+      {
+      scratch[n+i] = EvaluateBezierCurve(this->Value(patch, i, 0) + 3, BezierCutComponents,
+                                         n, 0.5, scratch);
+      }
+    double center = EvaluateBezierCurve(scratch + n, 1, m, 0.5, scratch);
+    int pairs[2][2] = {{0, 1}, {2, 3}};
+    if ((center >= 0.0) != (corners[0] >= 0.0))
+      {
+      pairs[0][0] = 3; pairs[0][1] = 0;
+      pairs[1][0] = 1; pairs[1][1] = 2;
+      }
+    for (int p=0; p<2; p++)
+      {
+      if (crossings[pairs[p][0]] != crossings[pairs[p][1]])
+        {
+        this->Segments.push_back(crossings[pairs[p][0]]);
+        this->Segments.push_back(crossings[pairs[p][1]]);
+        }
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkIdType BezierSurfacePlaneCut::InsertCrossing(double u, double v)
+{
+  // Crossings found from neighbouring sub-patches are the same root of the
+  // same boundary curve, up to round-off, so they are merged on a fine
+  // parametric grid (the neighbouring cells absorb roots rounded across a
+  // cell boundary)
+  const double scale = 1073741824.0; // 2^30
+  long long qu = std::llround(u*scale);
+  long long qv = std::llround(v*scale);
+  for (long long du=-1; du<=1; du++)
+    {
+    for (long long dv=-1; dv<=1; dv++)
+      {
+      auto it = this->Crossings.find(std::make_pair(qu+du, qv+dv));
+      if (it != this->Crossings.end())
+        {
+        return it->second;
+        }
+      }
+    }
+
+  vtkIdType id = static_cast<vtkIdType>(this->Parameters.size()/2);
+  this->Parameters.push_back(u);
+  this->Parameters.push_back(v);
+  this->Crossings[std::make_pair(qu, qv)] = id;
+  return id;
+}
+
+//-------------------------------------------------------------------------------
+// Join segments sharing end points into polylines. Open polylines start at
+// the crossings with the boundary of the surface; the remaining segments
+// form closed polylines.
+void JoinBezierCutSegments(vtkIdType numberOfPoints, const std::vector<vtkIdType> &segments,
+                           vtkCellArray *lines)
+{
+  vtkIdType numberOfSegments = static_cast<vtkIdType>(segments.size()/2);
+  std::vector<vtkIdType> offsets(numberOfPoints+1, 0);
+  for (vtkIdType id : segments)
+    {
+    offsets[id+1]++;
+    }
+  for (vtkIdType p=0; p<numberOfPoints; p++)
+    {
+    offsets[p+1] += offsets[p];
+    }
+  std::vector<vtkIdType> incidentSegments(segments.size());
+  std::vector<vtkIdType> fill(offsets.begin(), offsets.end()-1);
+  for (vtkIdType s=0; s<numberOfSegments; s++)
+    {
+    incidentSegments[fill[segments[2*s]]++] = s;
+    incidentSegments[fill[segments[2*s+1]]++] = s;
+    }
+
+  std::vector<bool> usedSegments(numberOfSegments, false);
+  std::vector<vtkIdType> polyline;
+  auto trace = [&](vtkIdType start)
+    {
+    polyline.clear();
+    polyline.push_back(start);
+    vtkIdType current = start;
+    bool extended = true;
+    while (extended)
+      {
+      extended = false;
+      for (vtkIdType k=offsets[current]; k<offsets[current+1]; k++)
+        {
+        vtkIdType s = incidentSegments[k];
+        if (!usedSegments[s])
+          {
+          usedSegments[s] = true;
+          current = (segments[2*s] == current) ? segments[2*s+1] : segments[2*s];
+          polyline.push_back(current);
+          extended = true;
+          break;
+          }
+        }
+      }
+    if (polyline.size() > 1)
+      {
+      lines->InsertNextCell(static_cast<vtkIdType>(polyline.size()), polyline.data());
+      }
+    };
+
+  for (int pass=0; pass<2; pass++)
+    {
+    for (vtkIdType p=0; p<numberOfPoints; p++)
+      {
+      bool odd = (offsets[p+1] - offsets[p]) % 2 == 1;
+      if (pass == 1 || odd)
+        {
+        trace(p);
+        }
+      }
+    }
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBezierSurfacePlaneCutter);
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfacePlaneCutter::vtkBezierSurfacePlaneCutter()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->Tolerance = 0.05;
+  this->MaximumSubdivisionDepth = 16;
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfacePlaneCutter::~vtkBezierSurfacePlaneCutter() = default;
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePlaneCutter::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Surface: " << this->Surface.GetPointer() << "\n";
+  os << indent << "Plane: " << this->Plane.GetPointer() << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Maximum Subdivision Depth: " << this->MaximumSubdivisionDepth << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePlaneCutter::SetSurface(vtkBezierSurfaceSource *surface)
+{
+  if (this->Surface == surface)
+    {
+    return;
+    }
+
+  this->Surface = surface;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceSource *vtkBezierSurfacePlaneCutter::GetSurface() const
+{
+  return this->Surface;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePlaneCutter::SetPlane(vtkPlane *plane)
+{
+  if (this->Plane == plane)
+    {
+    return;
+    }
+
+  this->Plane = plane;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkPlane *vtkBezierSurfacePlaneCutter::GetPlane() const
+{
+  return this->Plane;
+}
+
+//-------------------------------------------------------------------------------
+vtkMTimeType vtkBezierSurfacePlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Surface)
+    {
+    mTime = std::max(mTime, this->Surface->GetMTime());
+    }
+  if (this->Plane)
+    {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+    }
+  return mTime;
+}
+
+//-------------------------------------------------------------------------------
+int vtkBezierSurfacePlaneCutter::RequestData(vtkInformation *vtkNotUsed(request),
+                                             vtkInformationVector **vtkNotUsed(inputVector),
+                                             vtkInformationVector *outputVector)
+{
+  vtkInformation *outputInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(outputInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!output)
+    {
+    return 0;
+    }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkCellArray> lines;
+  output->SetPoints(points);
+  output->SetLines(lines);
+
+  if (!this->Surface || !this->Plane)
+    {
+    return 1;
+    }
+
+  double origin[3];
+  double normal[3];
+  this->Plane->GetOrigin(origin);
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+    {
+    vtkErrorMacro("RequestData: the cutting plane has no normal.");
+    return 0;
+    }
+
+  // Control net with the signed distances of the control points
+  unsigned int m = this->Surface->GetNumberOfControlPointsX();
+  unsigned int n = this->Surface->GetNumberOfControlPointsY();
+  vtkSmartPointer<vtkPoints> controlPoints = this->Surface->GetControlPoints();
+  std::vector<double> patch(m*n*BezierCutComponents);
+  for (unsigned int k=0; k<m*n; k++)
+    {
+    double *value = &patch[k*BezierCutComponents];
+    controlPoints->GetPoint(k, value);
+    value[3] = vtkPlane::Evaluate(normal, origin, value);
+    }
+
+  BezierSurfacePlaneCut cut(m, n, this->Tolerance, this->MaximumSubdivisionDepth);
+  cut.Subdivide(patch.data(), 0.0, 1.0, 0.0, 1.0, 0);
+
+  // Crossings on the exact surface
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(cut.Parameters.size()/2);
+  vtkNew<vtkDoubleArray> coordinates;
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetNumberOfTuples(numberOfPoints);
+  this->Surface->EvaluatePoints(cut.Parameters.data(), numberOfPoints,
+                                coordinates->GetPointer(0));
+  points->SetData(coordinates);
+
+  JoinBezierCutSegments(numberOfPoints, cut.Segments, lines);
+
+  return 1;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfacePlaneCutter.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkBezierSurfacePlaneCutter_h
+#define __vtkBezierSurfacePlaneCutter_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+//-------------------------------------------------------------------------------
+class vtkBezierSurfaceSource;
+class vtkPlane;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class computes the intersection of the Bézier surface defined
+ * by a vtkBezierSurfaceSource with a plane, as a set of polylines.
+ *
+ * The intersection is computed on the exact surface rather than on its
+ * tessellation. The signed distance of the surface to the plane is itself a
+ * Bézier patch, whose coefficients are the signed distances of the control
+ * points. The patch is recursively subdivided at the middle of its
+ * parametric domain, and every sub-patch whose control points all lie on
+ * the same side of the plane is rejected (convex hull property). Sub-patches
+ * whose control net is flat within Tolerance are intersected as bilinear
+ * patches; the crossings of the plane with their boundaries are found on the
+ * exact boundary curves, so neighbouring sub-patches of different sizes share
+ * them and the segments are joined into polylines without cracks.
+ *
+ * The output is only recomputed when the control points of the surface or
+ * the plane change.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkBezierSurfacePlaneCutter : public vtkPolyDataAlgorithm
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkBezierSurfacePlaneCutter newly created.
+   */
+  static vtkBezierSurfacePlaneCutter *New();
+
+  vtkTypeMacro(vtkBezierSurfacePlaneCutter, vtkPolyDataAlgorithm);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set/get the surface to cut. The control points of the surface are used
+   * as they are, without updating its pipeline.
+   */
+  void SetSurface(vtkBezierSurfaceSource *surface);
+  vtkBezierSurfaceSource *GetSurface() const;
+
+  /**
+   * Set/get the cutting plane.
+   */
+  void SetPlane(vtkPlane *plane);
+  vtkPlane *GetPlane() const;
+
+  /**
+   * Set/get the largest deviation, in world units, of the control net of a
+   * sub-patch from a plane for the sub-patch to be intersected directly.
+   * The polylines are within about twice this distance of the exact
+   * intersection.
+   */
+  vtkSetClampMacro(Tolerance, double, 1e-6, VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance, double);
+
+  /**
+   * Set/get the maximum number of subdivisions of a sub-patch. Sub-patches
+   * at this depth are intersected even if they are not flat.
+   */
+  vtkSetClampMacro(MaximumSubdivisionDepth, unsigned int, 0, 40);
+  vtkGetMacro(MaximumSubdivisionDepth, unsigned int);
+
+  /**
+   * Get the modification time, including the one of the surface and of the
+   * plane.
+   */
+  vtkMTimeType GetMTime() override;
+
+ protected:
+  vtkBezierSurfacePlaneCutter();
+  ~vtkBezierSurfacePlaneCutter() override;
+
+  /**
+   * Compute the intersection polylines.
+   */
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+
+ private:
+  vtkBezierSurfacePlaneCutter(const vtkBezierSurfacePlaneCutter&);  // Not implemented.
+  void operator=(const vtkBezierSurfacePlaneCutter&);  // Not implemented.
+
+  vtkSmartPointer<vtkBezierSurfaceSource> Surface;
+  vtkSmartPointer<vtkPlane> Plane;
+  double Tolerance;
+  unsigned int MaximumSubdivisionDepth;
+};
+
+#endif
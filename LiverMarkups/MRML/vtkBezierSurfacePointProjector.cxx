@@ -0,0 +1,339 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkBezierSurfacePointProjector.h"
+#include "vtkBezierSurfaceSource.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkStaticPointLocator.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBezierSurfacePointProjector);
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfacePointProjector::vtkBezierSurfacePointProjector()
+{
+  this->SeedResolution = 32;
+  this->MaximumNumberOfIterations = 10;
+  this->ParametricTolerance = 1e-8;
+  this->Seeds = vtkSmartPointer<vtkPolyData>::New();
+  this->SeedLocator = vtkSmartPointer<vtkStaticPointLocator>::New();
+  this->SeedsResolution = 0;
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfacePointProjector::~vtkBezierSurfacePointProjector() = default;
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Surface: " << this->Surface.GetPointer() << "\n";
+  os << indent << "Seed Resolution: " << this->SeedResolution << "\n";
+  os << indent << "Maximum Number Of Iterations: " << this->MaximumNumberOfIterations << "\n";
+  os << indent << "Parametric Tolerance: " << this->ParametricTolerance << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::SetSurface(vtkBezierSurfaceSource *surface)
+{
+  if (this->Surface == surface)
+    {
+    return;
+    }
+
+  this->Surface = surface;
+  this->SeedsResolution = 0;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceSource *vtkBezierSurfacePointProjector::GetSurface() const
+{
+  return this->Surface;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::UpdateSeeds()
+{
+  unsigned int resolution = this->SeedResolution;
+  if (this->SeedsResolution == resolution &&
+      this->SeedsBuildTime > this->Surface->GetMTime())
+    {
+    return;
+    }
+
+  vtkIdType numberOfSeeds = static_cast<vtkIdType>(resolution)*resolution;
+  std::vector<double> parameters(2*numberOfSeeds);
+  for (unsigned int i=0; i<resolution; i++)
+    {
+    for (unsigned int j=0; j<resolution; j++)
+      {
+      parameters[2*(i*resolution+j)] = static_cast<double>(i)/(resolution-1);
+      parameters[2*(i*resolution+j)+1] = static_cast<double>(j)/(resolution-1);
+      }
+    }
+
+  vtkNew<vtkDoubleArray> seedCoordinates;
+  seedCoordinates->SetNumberOfComponents(3);
+  seedCoordinates->SetNumberOfTuples(numberOfSeeds);
+  this->Surface->EvaluatePoints(parameters.data(), numberOfSeeds,
+                                seedCoordinates->GetPointer(0));
+
+  vtkNew<vtkPoints> seedPoints;
+  seedPoints->SetData(seedCoordinates);
+  this->Seeds->SetPoints(seedPoints);
+  this->SeedLocator->SetDataSet(this->Seeds);
+  this->SeedLocator->BuildLocator();
+
+  this->SeedsResolution = resolution;
+  this->SeedsBuildTime.Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::ProjectPoints(const double *xyz, vtkIdType n,
+                                                   double *signedDistances,
+                                                   double *closestPoints,
+                                                   double *parameters)
+{
+  if (this->Surface == nullptr)
+    {
+    vtkErrorMacro("ProjectPoints: no surface set.");
+    return;
+    }
+
+  if (xyz == nullptr || signedDistances == nullptr || n <= 0)
+    {
+    return;
+    }
+
+  this->UpdateSeeds();
+
+  // Seed every point with its closest sample of the coarse grid
+  std::vector<double> localParameters(parameters ? 0 : 2*n);
+  double *uv = parameters ? parameters : localParameters.data();
+  unsigned int resolution = this->SeedsResolution;
+  vtkStaticPointLocator *locator = this->SeedLocator;
+  vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType k=begin; k<end; k++)
+      {
+      vtkIdType seed = locator->FindClosestPoint(xyz+3*k);
+      uv[2*k] = static_cast<double>(seed / resolution)/(resolution-1);
+      uv[2*k+1] = static_cast<double>(seed % resolution)/(resolution-1);
+      }
+    });
+
+  // Gauss-Newton iterations minimizing |S(u,v) - x|^2. Only the points that
+  // have not converged yet are evaluated in each iteration.
+  std::vector<double> localPoints(closestPoints ? 0 : 3*n);
+  double *points = closestPoints ? closestPoints : localPoints.data();
+  std::vector<double> derivativesU(3*n);
+  std::vector<double> derivativesV(3*n);
+  std::vector<double> activeParameters(2*n);
+  std::vector<vtkIdType> active(n);
+  std::vector<char> converged(n);
+  std::iota(active.begin(), active.end(), 0);
+  double tolerance = this->ParametricTolerance;
+
+  for (unsigned int iteration=0;
+       iteration<this->MaximumNumberOfIterations && !active.empty(); iteration++)
+    {
+    vtkIdType numberOfActivePoints = static_cast<vtkIdType>(active.size());
+    for (vtkIdType a=0; a<numberOfActivePoints; a++)
+      {
+      activeParameters[2*a] = uv[2*active[a]];
+      activeParameters[2*a+1] = uv[2*active[a]+1];
+      }
+
+    this->Surface->EvaluatePoints(activeParameters.data(), numberOfActivePoints, points,
+                                  derivativesU.data(), derivativesV.data());
+
+    vtkSMPTools::For(0, numberOfActivePoints, [&](vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType a=begin; a<end; a++)
+        {
+        const double *x = xyz+3*active[a];
+        const double *s = points+3*a;
+        const double *su = derivativesU.data()+3*a;
+        const double *sv = derivativesV.data()+3*a;
+        double residual[3] = {s[0]-x[0], s[1]-x[1], s[2]-x[2]};
+
+        double gradient[2] = {vtkMath::Dot(su, residual), vtkMath::Dot(sv, residual)};
+        double suu = vtkMath::Dot(su, su);
+        double suv = vtkMath::Dot(su, sv);
+        double svv = vtkMath::Dot(sv, sv);
+        double determinant = suu*svv-suv*suv;
+        if (determinant <= 1e-12*suu*svv || determinant <= 0.0)
+          {
+          // Degenerate parametrization, keep the current estimate
+          converged[a] = 1;
+          continue;
+          }
+
+        // When the step leaves the parametric domain along one direction, the
+        // other direction is solved again with the clamped step
+        double *p = uv+2*active[a];
+        double du = -(svv*gradient[0]-suv*gradient[1])/determinant;
+        double dv = -(suu*gradient[1]-suv*gradient[0])/determinant;
+        double u = vtkMath::ClampValue(p[0]+du, 0.0, 1.0);
+        double v = vtkMath::ClampValue(p[1]+dv, 0.0, 1.0);
+        if (u != p[0]+du && v == p[1]+dv)
+          {
+          v = vtkMath::ClampValue(p[1]-(gradient[1]+suv*(u-p[0]))/svv, 0.0, 1.0);
+          }
+        else if (v != p[1]+dv && u == p[0]+du)
+          {
+          u = vtkMath::ClampValue(p[0]-(gradient[0]+suv*(v-p[1]))/suu, 0.0, 1.0);
+          }
+        converged[a] = std::fabs(u-p[0]) <= tolerance && std::fabs(v-p[1]) <= tolerance;
+        p[0] = u;
+        p[1] = v;
+        }
+      });
+
+    vtkIdType numberOfRemainingPoints = 0;
+    for (vtkIdType a=0; a<numberOfActivePoints; a++)
+      {
+      if (!converged[a])
+        {
+        active[numberOfRemainingPoints++] = active[a];
+        }
+      }
+    active.resize(numberOfRemainingPoints);
+    }
+
+  // Closest points and signed distances at the final parameters
+  this->Surface->EvaluatePoints(uv, n, points, derivativesU.data(), derivativesV.data());
+  vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType k=begin; k<end; k++)
+      {
+      double difference[3];
+      vtkMath::Subtract(xyz+3*k, points+3*k, difference);
+      double normal[3];
+      vtkMath::Cross(derivativesU.data()+3*k, derivativesV.data()+3*k, normal);
+      double distance = vtkMath::Norm(difference);
+      signedDistances[k] = vtkMath::Dot(difference, normal) < 0.0 ? -distance : distance;
+      }
+    });
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::ProjectPoints(vtkDoubleArray *points,
+                                                   vtkDoubleArray *signedDistances,
+                                                   vtkDoubleArray *closestPoints,
+                                                   vtkDoubleArray *parameters)
+{
+  if (points == nullptr || signedDistances == nullptr || points->GetNumberOfComponents() != 3)
+    {
+    vtkErrorMacro("ProjectPoints: expected 3-component points and an output array.");
+    return;
+    }
+
+  vtkIdType n = points->GetNumberOfTuples();
+  signedDistances->SetNumberOfComponents(1);
+  signedDistances->SetNumberOfTuples(n);
+  if (closestPoints)
+    {
+    closestPoints->SetNumberOfComponents(3);
+    closestPoints->SetNumberOfTuples(n);
+    }
+  if (parameters)
+    {
+    parameters->SetNumberOfComponents(2);
+    parameters->SetNumberOfTuples(n);
+    }
+
+  this->ProjectPoints(points->GetPointer(0), n, signedDistances->GetPointer(0),
+                      closestPoints ? closestPoints->GetPointer(0) : nullptr,
+                      parameters ? parameters->GetPointer(0) : nullptr);
+
+  signedDistances->Modified();
+  if (closestPoints)
+    {
+    closestPoints->Modified();
+    }
+  if (parameters)
+    {
+    parameters->Modified();
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfacePointProjector::ProjectPoints(vtkPoints *points,
+                                                   vtkDoubleArray *signedDistances,
+                                                   vtkDoubleArray *closestPoints,
+                                                   vtkDoubleArray *parameters)
+{
+  if (points == nullptr)
+    {
+    vtkErrorMacro("ProjectPoints: no points.");
+    return;
+    }
+
+  vtkSmartPointer<vtkDoubleArray> coordinates = vtkDoubleArray::SafeDownCast(points->GetData());
+  if (coordinates == nullptr)
+    {
+    coordinates = vtkSmartPointer<vtkDoubleArray>::New();
+    coordinates->DeepCopy(points->GetData());
+    }
+
+  this->ProjectPoints(coordinates, signedDistances, closestPoints, parameters);
+}
+
+//-------------------------------------------------------------------------------
+double vtkBezierSurfacePointProjector::ProjectPoint(const double point[3],
+                                                   double closestPoint[3],
+                                                   double parameters[2])
+{
+  double signedDistance = 0.0;
+  this->ProjectPoints(point, 1, &signedDistance, closestPoint, parameters);
+  return signedDistance;
+}
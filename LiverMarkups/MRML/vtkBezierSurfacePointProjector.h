@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkBezierSurfacePointProjector_h
+#define __vtkBezierSurfacePointProjector_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+//-------------------------------------------------------------------------------
+class vtkBezierSurfaceSource;
+class vtkDoubleArray;
+class vtkPoints;
+class vtkPolyData;
+class vtkStaticPointLocator;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class projects points onto the Bézier surface defined by a
+ * vtkBezierSurfaceSource and computes their signed distance to it.
+ *
+ * Each point is seeded with the closest sample of a coarse grid of the
+ * surface (found through a static point locator) and the parameters of its
+ * closest point are then refined by Gauss-Newton iterations on
+ * \f$(u,v)\f$, clamped to the parametric domain. The seed grid is cached and
+ * only rebuilt when the surface changes. The sign of the distance is given by
+ * the analytic normal \f$S_u\times S_v\f$ at the closest point. Batches of
+ * points are processed in parallel with vtkSMPTools.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkBezierSurfacePointProjector : public vtkObject
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkBezierSurfacePointProjector newly created.
+   */
+  static vtkBezierSurfacePointProjector *New();
+
+  vtkTypeMacro(vtkBezierSurfacePointProjector, vtkObject);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set/get the surface the points are projected onto. The control points of
+   * the surface are used as they are, without updating its pipeline.
+   */
+  void SetSurface(vtkBezierSurfaceSource *surface);
+  vtkBezierSurfaceSource *GetSurface() const;
+
+  /**
+   * Set/get the number of samples, in each parametric direction, of the grid
+   * used to seed the projections. Finer grids find the global closest point
+   * of strongly curved surfaces more reliably, at a higher setup cost.
+   */
+  vtkSetClampMacro(SeedResolution, unsigned int, 2, 1024);
+  vtkGetMacro(SeedResolution, unsigned int);
+
+  /**
+   * Set/get the maximum number of Gauss-Newton iterations per point.
+   */
+  vtkSetMacro(MaximumNumberOfIterations, unsigned int);
+  vtkGetMacro(MaximumNumberOfIterations, unsigned int);
+
+  /**
+   * Set/get the parametric step below which the iterations of a point stop.
+   */
+  vtkSetClampMacro(ParametricTolerance, double, 0.0, 1.0);
+  vtkGetMacro(ParametricTolerance, double);
+
+#if !defined(__VTK_WRAP__)
+  /**
+   * Project n points onto the surface.
+   *
+   * @param xyz n query points.
+   * @param n number of query points.
+   * @param signedDistances output buffer for the n signed distances to the
+   * surface (positive on the side of the surface normal).
+   * @param closestPoints optional output buffer for the n closest points.
+   * @param parameters optional output buffer for the n (u, v) parameters of
+   * the closest points.
+   */
+  void ProjectPoints(const double *xyz, vtkIdType n, double *signedDistances,
+                     double *closestPoints = nullptr, double *parameters = nullptr);
+#endif
+
+  /**
+   * Array variant of ProjectPoints. The outputs are resized to the number of
+   * points (see vtkBezierSurfaceSource::EvaluatePoints).
+   *
+   * @param points query points, in double precision.
+   * @param signedDistances output signed distances.
+   * @param closestPoints optional output closest points (3 components).
+   * @param parameters optional output parameters (2 components).
+   */
+  void ProjectPoints(vtkDoubleArray *points, vtkDoubleArray *signedDistances,
+                     vtkDoubleArray *closestPoints = nullptr,
+                     vtkDoubleArray *parameters = nullptr);
+
+  /**
+   * Project the points of a vtkPoints object (converted to double precision
+   * if needed).
+   */
+  void ProjectPoints(vtkPoints *points, vtkDoubleArray *signedDistances,
+                     vtkDoubleArray *closestPoints = nullptr,
+                     vtkDoubleArray *parameters = nullptr);
+
+  /**
+   * Project a single point.
+   *
+   * @return signed distance of the point to the surface.
+   */
+  double ProjectPoint(const double point[3], double closestPoint[3] = nullptr,
+                      double parameters[2] = nullptr);
+
+ protected:
+  vtkBezierSurfacePointProjector();
+  ~vtkBezierSurfacePointProjector() override;
+
+ private:
+  vtkBezierSurfacePointProjector(const vtkBezierSurfacePointProjector&);  // Not implemented.
+  void operator=(const vtkBezierSurfacePointProjector&);  // Not implemented.
+
+  /**
+   * Rebuild the seed grid and its locator if the surface or the seed
+   * resolution changed since they were last built.
+   */
+  void UpdateSeeds();
+
+  vtkSmartPointer<vtkBezierSurfaceSource> Surface;
+  unsigned int SeedResolution;
+  unsigned int MaximumNumberOfIterations;
+  double ParametricTolerance;
+
+  vtkSmartPointer<vtkPolyData> Seeds;            // Coarse samples of the surface
+  vtkSmartPointer<vtkStaticPointLocator> SeedLocator;
+  unsigned int SeedsResolution;                  // Resolution the seeds were built with
+  vtkTimeStamp SeedsBuildTime;
+};
+
+#endif
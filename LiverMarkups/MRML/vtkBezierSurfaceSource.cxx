@@ -0,0 +1,1682 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+#include "vtkBezierSurfaceSource.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkInformation.h>
+#include <vtkExecutive.h>
+#include <vtkInformationVector.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <tuple>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+constexpr unsigned long Binomial(unsigned int n, unsigned int k)
+{
+  return (k == 0 || k == n) ? 1 : Binomial(n-1, k-1) + Binomial(n-1, k);
+}
+
+//-------------------------------------------------------------------------------
+// Bernstein polynomials of a fixed degree and their derivatives. The
+// recursion over I unrolls the evaluation at compile time and the binomial
+// coefficients are compile-time constants.
+template <unsigned int Degree, unsigned int I = 0>
+struct BernsteinPolynomials
+{
+  static void Evaluate(const double *tPowers, const double *sPowers,
+                       double *basis, double *derivative)
+  {
+    constexpr double binomial = Binomial(Degree, I);
+
+    basis[I] = binomial * tPowers[I] * sPowers[Degree-I];
+    derivative[I] = binomial *
+      ((I > 0 ? I * tPowers[I-1] * sPowers[Degree-I] : 0.0) -
+       (I < Degree ? (Degree-I) * tPowers[I] * sPowers[Degree-I-1] : 0.0));
+
+    BernsteinPolynomials<Degree, I+1>::Evaluate(tPowers, sPowers, basis, derivative);
+  }
+};
+
+template <unsigned int Degree>
+struct BernsteinPolynomials<Degree, Degree+1>
+{
+  static void Evaluate(const double *, const double *, double *, double *) {}
+};
+
+template <unsigned int Degree>
+void EvaluateBernsteinPolynomials(double t, double *basis, double *derivative)
+{
+  double tPowers[Degree+1];
+  double sPowers[Degree+1];
+
+  tPowers[0] = 1.0;
+  sPowers[0] = 1.0;
+  for (unsigned int k=1; k<=Degree; k++)
+    {
+    tPowers[k] = tPowers[k-1] * t;
+    sPowers[k] = sPowers[k-1] * (1-t);
+    }
+
+  BernsteinPolynomials<Degree>::Evaluate(tPowers, sPowers, basis, derivative);
+}
+
+//-------------------------------------------------------------------------------
+// Bernstein polynomials of any degree in power form, binomial*t^i*(1-t)^(n-i),
+// from running powers of t and 1-t.
+void EvaluateBernsteinPolynomialsPowerForm(unsigned int numberOfControlPoints,
+                                           const double *binomials, double t,
+                                           double *basis, double *derivative)
+{
+  unsigned int degree = numberOfControlPoints-1;
+
+  // The powers of t are kept in basis, and consumed from the highest degree
+  // down while the powers of 1-t are accumulated.
+  basis[0] = 1.0;
+  for (unsigned int i=1; i<=degree; i++)
+    {
+    basis[i] = basis[i-1]*t;
+    }
+
+  double sPower = 1.0;          // (1-t)^(degree-i)
+  double previousSPower = 0.0;  // (1-t)^(degree-i-1)
+  for (unsigned int k=0; k<=degree; k++)
+    {
+    unsigned int i = degree-k;
+    double tPower = basis[i];
+    double previousTPower = (i > 0) ? basis[i-1] : 0.0;
+    basis[i] = binomials[i]*tPower*sPower;
+    derivative[i] = binomials[i]*(i*previousTPower*sPower - (degree-i)*tPower*previousSPower);
+    previousSPower = sPower;
+    sPower *= (1-t);
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Bernstein polynomials of any degree from the de Casteljau recurrence
+// B(i,k) = (1-t)*B(i,k-1) + t*B(i-1,k-1). It only involves convex
+// combinations, so it needs no binomial coefficients and is stable for any
+// degree, at a quadratic cost in the degree.
+void EvaluateBernsteinPolynomialsDeCasteljau(unsigned int numberOfControlPoints,
+                                             double t, double *basis, double *derivative)
+{
+  unsigned int degree = numberOfControlPoints-1;
+  double s = 1-t;
+
+  // Polynomials of degree-1, which give the derivatives...
+  basis[0] = 1.0;
+  for (unsigned int k=1; k<degree; k++)
+    {
+    basis[k] = t*basis[k-1];
+    for (unsigned int i=k-1; i>0; i--)
+      {
+      basis[i] = s*basis[i] + t*basis[i-1];
+      }
+    basis[0] *= s;
+    }
+
+  for (unsigned int i=0; i<=degree; i++)
+    {
+    derivative[i] = degree*((i > 0 ? basis[i-1] : 0.0) - (i < degree ? basis[i] : 0.0));
+    }
+
+  // ... and one more step of the recurrence
+  basis[degree] = t*basis[degree-1];
+  for (unsigned int i=degree-1; i>0; i--)
+    {
+    basis[i] = s*basis[i] + t*basis[i-1];
+    }
+  basis[0] *= s;
+}
+
+//-------------------------------------------------------------------------------
+// Evaluation of the Bernstein polynomials (and derivatives) of the given
+// number of control points at t. The common bi-quadratic and bi-cubic cases
+// are dispatched to the fixed-degree implementation; other degrees use the
+// power form, or the de Casteljau recurrence from deCasteljauThreshold
+// control points.
+void EvaluateBernsteinPolynomials(unsigned int numberOfControlPoints,
+                                  const double *binomials, double t,
+                                  double *basis, double *derivative,
+                                  unsigned int deCasteljauThreshold)
+{
+  switch (numberOfControlPoints)
+    {
+    case 3:
+      EvaluateBernsteinPolynomials<2>(t, basis, derivative);
+      return;
+    case 4:
+      EvaluateBernsteinPolynomials<3>(t, basis, derivative);
+      return;
+    default:
+      break;
+    }
+
+  if (numberOfControlPoints >= deCasteljauThreshold)
+    {
+    EvaluateBernsteinPolynomialsDeCasteljau(numberOfControlPoints, t, basis, derivative);
+    }
+  else
+    {
+    EvaluateBernsteinPolynomialsPowerForm(numberOfControlPoints, binomials, t, basis, derivative);
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Number of grid samples along v evaluated together by the kernel. The inner
+// loops run over a block of samples with contiguous basis values, so the
+// compiler maps them to SIMD lanes (2 doubles per SSE2/NEON register, 4 per
+// AVX register). The v basis tables are padded to a multiple of this size.
+const unsigned int BezierBlockSize = 8;
+
+//-------------------------------------------------------------------------------
+inline unsigned int PaddedResolution(unsigned int resolution)
+{
+  return (resolution + BezierBlockSize - 1) / BezierBlockSize * BezierBlockSize;
+}
+
+//-------------------------------------------------------------------------------
+// Grids with fewer samples than this are evaluated serially: waking up the
+// SMP worker threads costs more than evaluating them, which matters for the
+// coarse grids updated on every mouse move. Larger grids are split into
+// chunks of rows of about this many samples.
+const vtkIdType BezierParallelGrainSize = 4096;
+
+//-------------------------------------------------------------------------------
+// Run functor(rowBegin, rowEnd) over the rows of a grid, in parallel with
+// vtkSMPTools when the grid is large enough.
+template <typename Functor>
+void ForEachGridRow(vtkIdType numberOfRows, vtkIdType samplesPerRow, Functor &&functor)
+{
+  if (numberOfRows*samplesPerRow < BezierParallelGrainSize)
+    {
+    functor(0, numberOfRows);
+    return;
+    }
+
+  vtkIdType grain = std::max<vtkIdType>(1, BezierParallelGrainSize / std::max<vtkIdType>(1, samplesPerRow));
+  vtkSMPTools::For(0, numberOfRows, grain, functor);
+}
+
+//-------------------------------------------------------------------------------
+// Buffers taking part in the evaluation of the Bézier surface grid
+struct BezierSurfaceGridBuffers
+{
+  unsigned int NumberOfControlPoints[2];
+  unsigned int Resolution[2];
+  bool ComputeNormals;
+  const double *ControlPoints;    // control net as x, y and z blocks (u-major)
+  const double *BasisU;
+  const double *DerivativeBasisU;
+  double *IntermediatePoints;
+  double *IntermediateDerivatives;
+  double *DerivativesU;
+  double *DerivativesV;
+};
+
+//-------------------------------------------------------------------------------
+// Buffers depending on the output precision. Real is the precision of the
+// output points and normals; the samples along v are accumulated in that
+// precision as well, so single precision output fits twice as many samples
+// per SIMD register.
+template <typename Real>
+struct BezierSurfaceGridEvaluation : public BezierSurfaceGridBuffers
+{
+  const Real *BasisV;
+  const Real *DerivativeBasisV;
+  Real *Points;
+  Real *Normals;
+};
+
+//-------------------------------------------------------------------------------
+// Evaluation of the Bézier surface grid as S = Bu * P * Bv^T. M and N are the
+// number of control points in u and v when they are known at compile time
+// (the loops over the control net then have constant trip counts and get
+// unrolled), or 0 for the generic case, where they are read at runtime.
+template <typename Real, unsigned int M, unsigned int N>
+void EvaluateBezierSurfaceGrid(const BezierSurfaceGridEvaluation<Real> &evaluation)
+{
+  const unsigned int xGrid = M ? M : evaluation.NumberOfControlPoints[0];
+  const unsigned int yGrid = N ? N : evaluation.NumberOfControlPoints[1];
+  const unsigned int numberOfControlPoints = xGrid*yGrid;
+  unsigned int xRes = evaluation.Resolution[0];
+  unsigned int yRes = evaluation.Resolution[1];
+  unsigned int paddedYRes = PaddedResolution(yRes);
+  bool computeNormals = evaluation.ComputeNormals;
+
+  // Every grid row is evaluated independently. First, the control net is
+  // collapsed along u for the row (Bu * P), stored as x, y and z blocks of
+  // NumberOfControlPoints[1].
+  ForEachGridRow(xRes, yRes, [&](vtkIdType rowBegin, vtkIdType rowEnd)
+    {
+    for (vtkIdType i=rowBegin; i<rowEnd; i++)
+      {
+      const double *basisU = evaluation.BasisU+i*xGrid;
+      const double *derivativeBasisU = evaluation.DerivativeBasisU+i*xGrid;
+      double *rowPoints = evaluation.IntermediatePoints+i*yGrid*3;
+      double *rowDerivatives = evaluation.IntermediateDerivatives+i*yGrid*3;
+
+      std::fill(rowPoints, rowPoints+yGrid*3, 0.0);
+      std::fill(rowDerivatives, rowDerivatives+yGrid*3, 0.0);
+
+      for (unsigned int ci=0; ci<xGrid; ci++)
+        {
+        for (unsigned int c=0; c<3; c++)
+          {
+          const double *controlPoints =
+            evaluation.ControlPoints+c*numberOfControlPoints+ci*yGrid;
+          double *row = rowPoints+c*yGrid;
+          for (unsigned int cj=0; cj<yGrid; cj++)
+            {
+            row[cj] += controlPoints[cj] * basisU[ci];
+            }
+
+          if (computeNormals)
+            {
+            double *rowDerivative = rowDerivatives+c*yGrid;
+            for (unsigned int cj=0; cj<yGrid; cj++)
+              {
+              rowDerivative[cj] += controlPoints[cj] * derivativeBasisU[ci];
+              }
+            }
+          }
+        }
+
+      // ... and then the row is evaluated along v ((Bu * P) * Bv^T), one
+      // block of samples at a time. The partial derivatives are
+      // dS/du = (dBu/du * P) * Bv^T and dS/dv = (Bu * P) * dBv/dv^T, and the
+      // normal is dS/du x dS/dv.
+      const double *rowX = evaluation.IntermediatePoints+i*yGrid*3;
+      const double *rowY = rowX+yGrid;
+      const double *rowZ = rowY+yGrid;
+      const double *rowDerivativeX = evaluation.IntermediateDerivatives+i*yGrid*3;
+      const double *rowDerivativeY = rowDerivativeX+yGrid;
+      const double *rowDerivativeZ = rowDerivativeY+yGrid;
+
+      for (unsigned int j0=0; j0<yRes; j0+=BezierBlockSize)
+        {
+        Real x[BezierBlockSize] = {0};
+        Real y[BezierBlockSize] = {0};
+        Real z[BezierBlockSize] = {0};
+
+        for (unsigned int cj=0; cj<yGrid; cj++)
+          {
+          const Real *basisV = evaluation.BasisV+cj*paddedYRes+j0;
+          Real px = static_cast<Real>(rowX[cj]);
+          Real py = static_cast<Real>(rowY[cj]);
+          Real pz = static_cast<Real>(rowZ[cj]);
+          for (unsigned int k=0; k<BezierBlockSize; k++)
+            {
+            x[k] += px * basisV[k];
+            y[k] += py * basisV[k];
+            z[k] += pz * basisV[k];
+            }
+          }
+
+        unsigned int blockSize = std::min(BezierBlockSize, yRes-j0);
+        Real *points = evaluation.Points+(i*yRes+j0)*3;
+        for (unsigned int k=0; k<blockSize; k++)
+          {
+          points[k*3]   = x[k];
+          points[k*3+1] = y[k];
+          points[k*3+2] = z[k];
+          }
+
+        if (!computeNormals)
+          {
+          continue;
+          }
+
+        Real dux[BezierBlockSize] = {0};
+        Real duy[BezierBlockSize] = {0};
+        Real duz[BezierBlockSize] = {0};
+        Real dvx[BezierBlockSize] = {0};
+        Real dvy[BezierBlockSize] = {0};
+        Real dvz[BezierBlockSize] = {0};
+
+        for (unsigned int cj=0; cj<yGrid; cj++)
+          {
+          const Real *basisV = evaluation.BasisV+cj*paddedYRes+j0;
+          const Real *derivativeBasisV = evaluation.DerivativeBasisV+cj*paddedYRes+j0;
+          Real px = static_cast<Real>(rowX[cj]);
+          Real py = static_cast<Real>(rowY[cj]);
+          Real pz = static_cast<Real>(rowZ[cj]);
+          Real dx = static_cast<Real>(rowDerivativeX[cj]);
+          Real dy = static_cast<Real>(rowDerivativeY[cj]);
+          Real dz = static_cast<Real>(rowDerivativeZ[cj]);
+          for (unsigned int k=0; k<BezierBlockSize; k++)
+            {
+            dux[k] += dx * basisV[k];
+            duy[k] += dy * basisV[k];
+            duz[k] += dz * basisV[k];
+            dvx[k] += px * derivativeBasisV[k];
+            dvy[k] += py * derivativeBasisV[k];
+            dvz[k] += pz * derivativeBasisV[k];
+            }
+          }
+
+        Real nx[BezierBlockSize];
+        Real ny[BezierBlockSize];
+        Real nz[BezierBlockSize];
+        for (unsigned int k=0; k<BezierBlockSize; k++)
+          {
+          nx[k] = duy[k] * dvz[k] - duz[k] * dvy[k];
+          ny[k] = duz[k] * dvx[k] - dux[k] * dvz[k];
+          nz[k] = dux[k] * dvy[k] - duy[k] * dvx[k];
+          Real norm = std::sqrt(nx[k] * nx[k] + ny[k] * ny[k] + nz[k] * nz[k]);
+          Real scale = (norm > 0) ? 1 / norm : 0;
+          nx[k] *= scale;
+          ny[k] *= scale;
+          nz[k] *= scale;
+          }
+
+        Real *normals = evaluation.Normals+(i*yRes+j0)*3;
+        double *derivativesU = evaluation.DerivativesU+(i*yRes+j0)*3;
+        double *derivativesV = evaluation.DerivativesV+(i*yRes+j0)*3;
+        for (unsigned int k=0; k<blockSize; k++)
+          {
+          normals[k*3]   = nx[k];
+          normals[k*3+1] = ny[k];
+          normals[k*3+2] = nz[k];
+          derivativesU[k*3]   = dux[k];
+          derivativesU[k*3+1] = duy[k];
+          derivativesU[k*3+2] = duz[k];
+          derivativesV[k*3]   = dvx[k];
+          derivativesV[k*3+1] = dvy[k];
+          derivativesV[k*3+2] = dvz[k];
+          }
+        }
+      }
+    });
+}
+
+//-------------------------------------------------------------------------------
+// Dispatch to the kernels specialized for the common bi-cubic and
+// bi-quadratic patches; any other size takes the generic path.
+template <typename Real>
+void EvaluateBezierSurfaceGrid(const BezierSurfaceGridEvaluation<Real> &evaluation)
+{
+  unsigned int xGrid = evaluation.NumberOfControlPoints[0];
+  unsigned int yGrid = evaluation.NumberOfControlPoints[1];
+
+  if (xGrid == 4 && yGrid == 4)
+    {
+    EvaluateBezierSurfaceGrid<Real,4,4>(evaluation);
+    }
+  else if (xGrid == 3 && yGrid == 3)
+    {
+    EvaluateBezierSurfaceGrid<Real,3,3>(evaluation);
+    }
+  else
+    {
+    EvaluateBezierSurfaceGrid<Real,0,0>(evaluation);
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Number of incremental updates after which the surface is fully re-evaluated
+// to discard the accumulated round-off error.
+const unsigned int MaximumNumberOfIncrementalUpdates = 64;
+
+//-------------------------------------------------------------------------------
+// Construction of the cells of a grid of xRes x yRes points, either as two
+// triangles per quad or as one triangle strip per row of quads. Both keep
+// the orientation of the (u, v) parametrization.
+vtkSmartPointer<vtkCellArray> BuildGridTopology(unsigned int xRes, unsigned int yRes,
+                                                bool triangleStrips)
+{
+  vtkSmartPointer<vtkCellArray> topology = vtkSmartPointer<vtkCellArray>::New();
+
+  if (xRes < 2 || yRes < 2)
+    {
+    return topology;
+    }
+
+  if (triangleStrips)
+    {
+    std::vector<vtkIdType> strip(2*yRes);
+    for (unsigned int i=0; i<xRes-1; i++)
+      {
+      for (unsigned int j=0; j<yRes; j++)
+        {
+        strip[2*j] = i*yRes + j;
+        strip[2*j+1] = (i+1)*yRes + j;
+        }
+      topology->InsertNextCell(static_cast<vtkIdType>(strip.size()), strip.data());
+      }
+    return topology;
+    }
+
+  for (unsigned int i=0; i<xRes-1; i++)
+    {
+    for (unsigned int j=0; j<yRes-1; j++)
+      {
+      unsigned int base = i*yRes + j;
+      unsigned int a = base;
+      unsigned int b = base + 1;
+      unsigned int c = base + yRes + 1;
+      unsigned int d = base + yRes;
+      vtkIdType triangle[3];
+
+      triangle[0] = c;
+      triangle[1] = b;
+      triangle[2] = a;
+      topology->InsertNextCell(3, triangle);
+
+      triangle[0] = d;
+      triangle[1] = c;
+      triangle[2] = a;
+      topology->InsertNextCell(3, triangle);
+      }
+    }
+
+  return topology;
+}
+
+//-------------------------------------------------------------------------------
+// Process-wide cache of grid topologies. Sources sharing a resolution and
+// topology mode share one cell array, which must therefore never be modified
+// once built. Entries are released with the last source using them.
+vtkSmartPointer<vtkCellArray> GetGridTopology(unsigned int xRes, unsigned int yRes,
+                                              bool triangleStrips)
+{
+  typedef std::tuple<unsigned int, unsigned int, bool> TopologyKey;
+  static std::map<TopologyKey, vtkWeakPointer<vtkCellArray> > topologies;
+  static std::mutex topologiesMutex;
+
+  std::lock_guard<std::mutex> lock(topologiesMutex);
+
+  TopologyKey key(xRes, yRes, triangleStrips);
+  vtkSmartPointer<vtkCellArray> topology = topologies[key].GetPointer();
+  if (topology)
+    {
+    return topology;
+    }
+
+  // Drop the entries whose topology is no longer used
+  for (auto it = topologies.begin(); it != topologies.end(); )
+    {
+    it = (it->second == nullptr) ? topologies.erase(it) : std::next(it);
+    }
+
+  topology = BuildGridTopology(xRes, yRes, triangleStrips);
+  topologies[key] = topology;
+
+  return topology;
+}
+
+//-------------------------------------------------------------------------------
+// Control points (x, y, z) of the restriction of a Bézier curve to [a, b],
+// obtained by splitting the curve twice with de Casteljau's algorithm.
+void ExtractBezierSubCurve(const double *controlPoints, unsigned int stride,
+                           unsigned int numberOfControlPoints,
+                           double a, double b, double *subCurve)
+{
+  for (unsigned int k=0; k<numberOfControlPoints; k++)
+    {
+    for (unsigned int c=0; c<3; c++)
+      {
+      subCurve[k*3+c] = controlPoints[k*stride+c];
+      }
+    }
+
+  // Split at b and keep the left part (the curve on [0, b])...
+  for (unsigned int r=1; r<numberOfControlPoints; r++)
+    {
+    for (unsigned int k=numberOfControlPoints-1; k>=r; k--)
+      {
+      for (unsigned int c=0; c<3; c++)
+        {
+        subCurve[k*3+c] = (1-b)*subCurve[(k-1)*3+c] + b*subCurve[k*3+c];
+        }
+      }
+    }
+
+  // ... then split it at a/b and keep the right part
+  double t = (b > 0.0) ? a/b : 0.0;
+  for (unsigned int r=1; r<numberOfControlPoints; r++)
+    {
+    for (unsigned int k=0; k<numberOfControlPoints-r; k++)
+      {
+      for (unsigned int c=0; c<3; c++)
+        {
+        subCurve[k*3+c] = (1-t)*subCurve[k*3+c] + t*subCurve[(k+1)*3+c];
+        }
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Flatness of a Bézier curve: the largest distance of its control points to
+// the chord joining its end points, which bounds the deviation of the curve
+// from the chord (convex hull property).
+double BezierCurveFlatness(const double *controlPoints, unsigned int numberOfControlPoints)
+{
+  const double *p0 = controlPoints;
+  const double *p1 = controlPoints+(numberOfControlPoints-1)*3;
+  double chord[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+  double chordLength2 = vtkMath::Dot(chord, chord);
+
+  double flatness = 0.0;
+  for (unsigned int k=1; k+1<numberOfControlPoints; k++)
+    {
+    const double *p = controlPoints+k*3;
+    double d[3] = {p[0]-p0[0], p[1]-p0[1], p[2]-p0[2]};
+    double t = (chordLength2 > 0.0) ? vtkMath::Dot(d, chord)/chordLength2 : 0.0;
+    t = std::min(1.0, std::max(0.0, t));
+    double e[3] = {d[0]-t*chord[0], d[1]-t*chord[1], d[2]-t*chord[2]};
+    flatness = std::max(flatness, vtkMath::Norm(e));
+    }
+
+  return flatness;
+}
+
+//-------------------------------------------------------------------------------
+// Adaptive sampling of one parametric direction of the control net. The net
+// is seen as numberOfCurves Bézier curves along that direction (the surface
+// iso-curves are convex combinations of them). Parameter intervals are
+// bisected, worst first, until every curve is within tolerance of its chord
+// on every interval or maximumNumberOfSamples is reached.
+std::vector<double> ComputeAdaptiveParameters(const double *controlPoints,
+                                              unsigned int numberOfCurves,
+                                              unsigned int curveStride,
+                                              unsigned int numberOfControlPoints,
+                                              unsigned int pointStride,
+                                              double tolerance,
+                                              unsigned int maximumNumberOfSamples)
+{
+  std::vector<double> subCurve(numberOfControlPoints*3);
+  auto intervalError = [&](double a, double b)
+    {
+    double error = 0.0;
+    for (unsigned int curve=0; curve<numberOfCurves; curve++)
+      {
+      ExtractBezierSubCurve(controlPoints+curve*curveStride, pointStride,
+                            numberOfControlPoints, a, b, subCurve.data());
+      error = std::max(error, BezierCurveFlatness(subCurve.data(), numberOfControlPoints));
+      }
+    return error;
+    };
+
+  typedef std::tuple<double, double, double> Interval; // error, start, end
+  std::priority_queue<Interval> intervals;
+  std::vector<double> parameters(1, 1.0);
+  intervals.push(Interval(intervalError(0.0, 1.0), 0.0, 1.0));
+
+  while (!intervals.empty())
+    {
+    Interval interval = intervals.top();
+    double start = std::get<1>(interval);
+    double end = std::get<2>(interval);
+    if (std::get<0>(interval) <= tolerance ||
+        intervals.size()+1 >= std::max(maximumNumberOfSamples, 2u))
+      {
+      break;
+      }
+    intervals.pop();
+
+    double middle = 0.5*(start+end);
+    intervals.push(Interval(intervalError(start, middle), start, middle));
+    intervals.push(Interval(intervalError(middle, end), middle, end));
+    }
+
+  while (!intervals.empty())
+    {
+    parameters.push_back(std::get<1>(intervals.top()));
+    intervals.pop();
+    }
+  std::sort(parameters.begin(), parameters.end());
+
+  return parameters;
+}
+
+//-------------------------------------------------------------------------------
+// Uniform sampling of [0, 1]
+std::vector<double> ComputeUniformParameters(unsigned int numberOfSamples)
+{
+  std::vector<double> parameters(numberOfSamples);
+  for (unsigned int i=0; i<numberOfSamples; i++)
+    {
+    parameters[i] = (numberOfSamples > 1) ? i / static_cast<double>(numberOfSamples - 1) : 0.0;
+    }
+
+  return parameters;
+}
+
+//-------------------------------------------------------------------------------
+// Evaluation of the surface, and optionally its partial derivatives, at
+// arbitrary parameters. As for the grid kernels, M and N are the number of
+// control points when known at compile time (the basis is then evaluated by
+// the fixed-degree kernels and the loops over the control net unrolled), or 0
+// for the generic case. This is a vtkSMPTools functor over ranges of points.
+struct BezierSurfacePointsBuffers
+{
+  unsigned int NumberOfControlPoints[2];
+  const double *ControlPoints;    // control net as (x, y, z) tuples (u-major)
+  const double *BinomialCoefficientsU;
+  const double *BinomialCoefficientsV;
+  unsigned int DeCasteljauThreshold;
+  const double *Parameters;       // (u, v) pairs
+  double *Points;
+  double *DerivativesU;
+  double *DerivativesV;
+};
+
+template <unsigned int M, unsigned int N>
+struct BezierSurfacePointsEvaluation : BezierSurfacePointsBuffers
+{
+  BezierSurfacePointsEvaluation(const BezierSurfacePointsBuffers &buffers)
+    : BezierSurfacePointsBuffers(buffers) {}
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const unsigned int xGrid = M ? M : this->NumberOfControlPoints[0];
+    const unsigned int yGrid = N ? N : this->NumberOfControlPoints[1];
+    bool computeDerivatives = this->DerivativesU || this->DerivativesV;
+
+    double fixedBasis[2*(M+N) > 0 ? 2*(M+N) : 1];
+    std::vector<double> genericBasis((M && N) ? 0 : 2*(xGrid+yGrid));
+    double *basisU = (M && N) ? fixedBasis : genericBasis.data();
+    double *derivativeBasisU = basisU+xGrid;
+    double *basisV = derivativeBasisU+xGrid;
+    double *derivativeBasisV = basisV+yGrid;
+
+    for (vtkIdType k=begin; k<end; k++)
+      {
+      EvaluateBernsteinPolynomials(xGrid, this->BinomialCoefficientsU,
+                                   this->Parameters[k*2], basisU, derivativeBasisU,
+                                   this->DeCasteljauThreshold);
+      EvaluateBernsteinPolynomials(yGrid, this->BinomialCoefficientsV,
+                                   this->Parameters[k*2+1], basisV, derivativeBasisV,
+                                   this->DeCasteljauThreshold);
+
+      double point[3] = {0.0, 0.0, 0.0};
+      double derivativeU[3] = {0.0, 0.0, 0.0};
+      double derivativeV[3] = {0.0, 0.0, 0.0};
+      for (unsigned int i=0; i<xGrid; i++)
+        {
+        const double *controlPoints = this->ControlPoints+i*yGrid*3;
+        double row[3] = {0.0, 0.0, 0.0};
+        double rowDerivative[3] = {0.0, 0.0, 0.0};
+        for (unsigned int j=0; j<yGrid; j++)
+          {
+          for (unsigned int c=0; c<3; c++)
+            {
+            row[c] += basisV[j] * controlPoints[j*3+c];
+            rowDerivative[c] += derivativeBasisV[j] * controlPoints[j*3+c];
+            }
+          }
+
+        for (unsigned int c=0; c<3; c++)
+          {
+          point[c] += basisU[i] * row[c];
+          derivativeU[c] += derivativeBasisU[i] * row[c];
+          derivativeV[c] += basisU[i] * rowDerivative[c];
+          }
+        }
+
+      std::copy(point, point+3, this->Points+k*3);
+      if (computeDerivatives)
+        {
+        if (this->DerivativesU)
+          {
+          std::copy(derivativeU, derivativeU+3, this->DerivativesU+k*3);
+          }
+        if (this->DerivativesV)
+          {
+          std::copy(derivativeV, derivativeV+3, this->DerivativesV+k*3);
+          }
+        }
+      }
+  }
+};
+
+//-------------------------------------------------------------------------------
+template <unsigned int M, unsigned int N>
+void EvaluateBezierSurfacePoints(const BezierSurfacePointsBuffers &buffers, vtkIdType n)
+{
+  BezierSurfacePointsEvaluation<M,N> evaluation(buffers);
+  vtkSMPTools::For(0, n, evaluation);
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBezierSurfaceSource);
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceSource::vtkBezierSurfaceSource()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->OwnedControlPoints = vtkSmartPointer<vtkDoubleArray>::New();
+  this->OwnedControlPoints->SetNumberOfComponents(3);
+  this->WrappedControlPoints = vtkSmartPointer<vtkDoubleArray>::New();
+  this->WrappedControlPoints->SetNumberOfComponents(3);
+  this->ControlPoints = this->OwnedControlPoints;
+  this->OutputPoints = vtkSmartPointer<vtkPoints>::New();
+  this->BinomialCoefficientsX = 0;
+  this->BinomialCoefficientsY = 0;
+  this->NumberOfControlPoints[0] = 0;
+  this->NumberOfControlPoints[1] = 0;
+  this->Resolution[0] = 0;
+  this->Resolution[1] = 0;
+  this->GridResolution[0] = 0;
+  this->GridResolution[1] = 0;
+  this->AdaptiveTessellation = false;
+  this->AdaptiveTolerance = 0.1;
+  this->ComputeNormals = false;
+  this->DeCasteljauThreshold = 57;
+  this->OutputPointsPrecision = vtkAlgorithm::DOUBLE_PRECISION;
+  this->GenerateTriangleStrips = false;
+  this->EvaluationCacheValid = false;
+  this->EvaluatedNormals = false;
+  this->NumberOfIncrementalUpdates = 0;
+
+  //Note: default is bi-cubic bezier surface (cp=4x4)
+  this->SetNumberOfControlPoints(4,4);
+  this->SetResolution(10,10);
+}
+
+//-------------------------------------------------------------------------------
+vtkBezierSurfaceSource::~vtkBezierSurfaceSource()
+{
+  if (this->BinomialCoefficientsX != NULL)
+    {
+    delete [] this->BinomialCoefficientsX;
+    this->BinomialCoefficientsX = NULL;
+    }
+
+  if (this->BinomialCoefficientsY != NULL)
+    {
+    delete [] this->BinomialCoefficientsY;
+    this->BinomialCoefficientsY = NULL;
+    }
+
+  this->NumberOfControlPoints[0] = 0;
+  this->NumberOfControlPoints[1] = 0;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::PrintSelf(ostream &os, vtkIndent indent)
+{
+  vtkPolyDataAlgorithm::PrintSelf(os, indent);
+
+  os << "Resolution: " << this->Resolution[0] << ", " << this->Resolution[1] << "\n";
+
+  os << "Compute Normals: " << this->ComputeNormals << "\n";
+  os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Generate Triangle Strips: " << this->GenerateTriangleStrips << "\n";
+  os << indent << "Adaptive Tessellation: " << this->AdaptiveTessellation << "\n";
+  os << indent << "Adaptive Tolerance: " << this->AdaptiveTolerance << "\n";
+  os << indent << "De Casteljau Threshold: " << this->DeCasteljauThreshold << "\n";
+  os << indent << "Grid Resolution: " << this->GridResolution[0] << ", "
+     << this->GridResolution[1] << "\n";
+
+  os << "Number of Control Points : " <<
+    this->NumberOfControlPoints[0] << ", " <<
+    this->NumberOfControlPoints[1] << "\n";
+
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+
+  for(unsigned int i=0; i<xGrid; i++)
+    {
+    for(unsigned int j=0; j<yGrid; j++)
+      {
+      double cpt[3];
+      this->ControlPoints->GetTuple(i*yGrid+j, cpt);
+
+      os << "Control point[" << i << ", " << j << "] = "
+         << cpt[0] << ", " << cpt[1] << ", " << cpt[2] << "\n";
+      }
+    os << "\n";
+    }
+
+  for(unsigned int i=0; i<xGrid; i++)
+    {
+    os << "Binomial coefficient X[" << i << "] = "
+       << this->BinomialCoefficientsX[i] << "\n";
+    }
+
+  for(unsigned int i=0; i<yGrid; i++)
+    {
+    os << "Binomial coefficient Y[" << i << "] = "
+       << this->BinomialCoefficientsY[i] << "\n";
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkMTimeType vtkBezierSurfaceSource::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+
+  // Adopted control points may be modified in place
+  vtkMTimeType controlPointsMTime = this->ControlPoints->GetMTime();
+
+  return std::max(mTime, controlPointsMTime);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetControlPoints(vtkPoints *points)
+{
+  if (points == nullptr)
+    {
+    vtkErrorMacro("SetControlPoints: invalid points.");
+    return;
+    }
+
+  this->SetControlPoints(points->GetData());
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetControlPoints(vtkDataArray *points)
+{
+  vtkIdType numberOfControlPoints =
+    this->NumberOfControlPoints[0]*this->NumberOfControlPoints[1];
+
+  if (points == nullptr ||
+      points->GetNumberOfComponents() != 3 ||
+      points->GetNumberOfTuples() < numberOfControlPoints)
+    {
+    vtkErrorMacro("SetControlPoints: expected " << numberOfControlPoints
+                  << " 3-component control points.");
+    return;
+    }
+
+  // Double precision control points are adopted without copying them
+  vtkDoubleArray *doublePoints = vtkDoubleArray::SafeDownCast(points);
+  if (doublePoints != nullptr)
+    {
+    this->AdoptControlPoints(doublePoints);
+    return;
+    }
+
+  bool modified = (this->ControlPoints != this->OwnedControlPoints);
+  this->ControlPoints = this->OwnedControlPoints;
+
+  double *controlPoints = this->OwnedControlPoints->GetPointer(0);
+  for (vtkIdType i=0; i<numberOfControlPoints; i++)
+    {
+    double point[3];
+    points->GetTuple(i, point);
+    double *controlPoint = controlPoints+i*3;
+    if (controlPoint[0] != point[0] ||
+        controlPoint[1] != point[1] ||
+        controlPoint[2] != point[2])
+      {
+      controlPoint[0] = point[0];
+      controlPoint[1] = point[1];
+      controlPoint[2] = point[2];
+      modified = true;
+      }
+    }
+
+  if (modified)
+    {
+    this->Modified();
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetControlPoints(double *points)
+{
+  if (points == nullptr)
+    {
+    vtkErrorMacro("SetControlPoints: invalid points.");
+    return;
+    }
+
+  vtkIdType numberOfValues =
+    this->NumberOfControlPoints[0]*this->NumberOfControlPoints[1]*3;
+
+  if (this->WrappedControlPoints->GetPointer(0) != points ||
+      this->WrappedControlPoints->GetNumberOfValues() != numberOfValues)
+    {
+    // save=1: the buffer belongs to the caller and is never freed here
+    this->WrappedControlPoints->SetArray(points, numberOfValues, 1);
+    }
+
+  this->AdoptControlPoints(this->WrappedControlPoints);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::AdoptControlPoints(vtkDoubleArray *points)
+{
+  if (this->ControlPoints != points)
+    {
+    this->ControlPoints = points;
+    this->Modified();
+    return;
+    }
+
+  // The same array may have been modified in place since the last evaluation
+  this->MovedControlPoints.clear();
+  if (!this->EvaluationCacheValid ||
+      !this->FindMovedControlPoints(this->MovedControlPoints) ||
+      !this->MovedControlPoints.empty())
+    {
+    this->Modified();
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkSmartPointer<vtkPoints>
+vtkBezierSurfaceSource::GetControlPoints() const
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->GetData()->DeepCopy(this->ControlPoints);
+  points->SetNumberOfPoints(this->NumberOfControlPoints[0]*this->NumberOfControlPoints[1]);
+
+  return points;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetNumberOfControlPoints(unsigned int m, unsigned int n)
+{
+  //Assignment of less than 2 control points in any dimension will result in 2
+  //control points
+  unsigned int xGrid = (m<2) ? 2 : m;
+  unsigned int yGrid = (n<2) ? 2 : n;
+
+  if (this->NumberOfControlPoints[0] == xGrid && this->NumberOfControlPoints[1] == yGrid)
+    {
+    return;
+    }
+
+  if (this->BinomialCoefficientsX != NULL)
+    {
+    delete [] this->BinomialCoefficientsX;
+    this->BinomialCoefficientsX = NULL;
+    }
+
+  if (this->BinomialCoefficientsY != NULL)
+    {
+    delete [] this->BinomialCoefficientsY;
+    this->BinomialCoefficientsY = NULL;
+    }
+
+  this->NumberOfControlPoints[0] = xGrid;
+  this->NumberOfControlPoints[1] = yGrid;
+
+  // A single contiguous block holds all the control points
+  this->OwnedControlPoints->SetNumberOfTuples(xGrid*yGrid);
+
+  this->ResetControlPoints();
+  this->BinomialCoefficientsX = new double[xGrid];
+  this->BinomialCoefficientsY = new double[yGrid];
+  this->ComputeBinomialCoefficients();
+  this->ComputeBasisFunctions();
+  this->EvaluationCacheValid = false;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetDeCasteljauThreshold(unsigned int threshold)
+{
+  threshold = std::max(threshold, 2u);
+  if (this->DeCasteljauThreshold == threshold)
+    {
+    return;
+    }
+
+  this->DeCasteljauThreshold = threshold;
+  this->ComputeBasisFunctions();
+  this->EvaluationCacheValid = false;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::ResetControlPoints()
+{
+  unsigned int m = this->NumberOfControlPoints[0];
+  unsigned int n = this->NumberOfControlPoints[1];
+
+  double distx = 1.0 / static_cast<double>(m-1);
+  double disty = 1.0 / static_cast<double>(n-1);
+
+  this->ControlPoints = this->OwnedControlPoints;
+  double *controlPoints = this->OwnedControlPoints->GetPointer(0);
+
+  for (unsigned int i=0; i<m; i++)
+    {
+    for (unsigned int j=0; j<n; j++)
+      {
+      double *pt = controlPoints+(i*n+j)*3;
+      pt[0] = -0.5 + i*distx;
+      pt[1] = -0.5 + j*disty;
+      pt[2] = 0.0;
+      }
+    }
+
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetResolution(unsigned int x, unsigned int y)
+{
+  if (this->Resolution[0] == x && this->Resolution[1] == y)
+    {
+    return;
+    }
+
+  this->Resolution[0] = x;
+  this->Resolution[1] = y;
+
+  // The adaptive grid is recomputed on the next update
+  if (!this->AdaptiveTessellation)
+    {
+    this->SetGridParameters(ComputeUniformParameters(x), ComputeUniformParameters(y));
+    }
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetAdaptiveTessellation(bool adaptiveTessellation)
+{
+  if (this->AdaptiveTessellation == adaptiveTessellation)
+    {
+    return;
+    }
+
+  this->AdaptiveTessellation = adaptiveTessellation;
+  if (!this->AdaptiveTessellation)
+    {
+    this->SetGridParameters(ComputeUniformParameters(this->Resolution[0]),
+                            ComputeUniformParameters(this->Resolution[1]));
+    }
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::EvaluatePoints(const double *uv, vtkIdType n, double *xyz,
+                                            double *dU, double *dV) const
+{
+  if (uv == nullptr || xyz == nullptr || n <= 0)
+    {
+    return;
+    }
+
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+
+  BezierSurfacePointsBuffers buffers;
+  buffers.NumberOfControlPoints[0] = xGrid;
+  buffers.NumberOfControlPoints[1] = yGrid;
+  buffers.ControlPoints = this->ControlPoints->GetPointer(0);
+  buffers.BinomialCoefficientsU = this->BinomialCoefficientsX;
+  buffers.BinomialCoefficientsV = this->BinomialCoefficientsY;
+  buffers.DeCasteljauThreshold = this->DeCasteljauThreshold;
+  buffers.Parameters = uv;
+  buffers.Points = xyz;
+  buffers.DerivativesU = dU;
+  buffers.DerivativesV = dV;
+
+  if (xGrid == 4 && yGrid == 4)
+    {
+    EvaluateBezierSurfacePoints<4,4>(buffers, n);
+    }
+  else if (xGrid == 3 && yGrid == 3)
+    {
+    EvaluateBezierSurfacePoints<3,3>(buffers, n);
+    }
+  else
+    {
+    EvaluateBezierSurfacePoints<0,0>(buffers, n);
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::EvaluatePoints(vtkDoubleArray *uv, vtkDoubleArray *xyz,
+                                            vtkDoubleArray *dU, vtkDoubleArray *dV) const
+{
+  if (uv == nullptr || xyz == nullptr || uv->GetNumberOfComponents() != 2)
+    {
+    vtkErrorMacro("EvaluatePoints: expected 2-component parameters and an output array.");
+    return;
+    }
+
+  // Outputs are only reallocated if they are too small, so arrays wrapping
+  // numpy buffers of the right size are written in place
+  vtkIdType n = uv->GetNumberOfTuples();
+  double *derivatives[2] = {nullptr, nullptr};
+  vtkDoubleArray *derivativeArrays[2] = {dU, dV};
+  xyz->SetNumberOfComponents(3);
+  xyz->SetNumberOfTuples(n);
+  for (int d=0; d<2; d++)
+    {
+    if (derivativeArrays[d])
+      {
+      derivativeArrays[d]->SetNumberOfComponents(3);
+      derivativeArrays[d]->SetNumberOfTuples(n);
+      derivatives[d] = derivativeArrays[d]->GetPointer(0);
+      }
+    }
+
+  this->EvaluatePoints(uv->GetPointer(0), n, xyz->GetPointer(0),
+                       derivatives[0], derivatives[1]);
+
+  xyz->Modified();
+  for (int d=0; d<2; d++)
+    {
+    if (derivativeArrays[d])
+      {
+      derivativeArrays[d]->Modified();
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::GetGridResolution(unsigned int resolution[2]) const
+{
+  resolution[0] = this->GridResolution[0];
+  resolution[1] = this->GridResolution[1];
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetGridParameters(const std::vector<double> &parametersU,
+                                               const std::vector<double> &parametersV)
+{
+  if (this->ParametersU == parametersU && this->ParametersV == parametersV)
+    {
+    return;
+    }
+
+  this->ParametersU = parametersU;
+  this->ParametersV = parametersV;
+
+  bool resolutionChanged =
+    this->GridResolution[0] != parametersU.size() ||
+    this->GridResolution[1] != parametersV.size();
+  this->GridResolution[0] = static_cast<unsigned int>(parametersU.size());
+  this->GridResolution[1] = static_cast<unsigned int>(parametersV.size());
+
+  if (resolutionChanged)
+    {
+    this->CreateOutputArrays();
+    this->UpdateTopology();
+    }
+  this->ComputeBasisFunctions();
+  this->EvaluationCacheValid = false;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::UpdateAdaptiveGridParameters()
+{
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+  const double *controlPoints = this->ControlPoints->GetPointer(0);
+
+  // Half of the tolerance for each direction, as the deviations of the
+  // bilinear patches along u and v add up.
+  double tolerance = 0.5*this->AdaptiveTolerance;
+
+  // Along u: one curve per column of the control net ...
+  std::vector<double> parametersU =
+    ComputeAdaptiveParameters(controlPoints, yGrid, 3, xGrid, yGrid*3,
+                              tolerance, this->Resolution[0]);
+
+  // ... and along v: one curve per row.
+  std::vector<double> parametersV =
+    ComputeAdaptiveParameters(controlPoints, xGrid, yGrid*3, yGrid, 3,
+                              tolerance, this->Resolution[1]);
+
+  this->SetGridParameters(parametersU, parametersV);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetOutputPointsPrecision(int precision)
+{
+  if (this->OutputPointsPrecision == precision)
+    {
+    return;
+    }
+
+  this->OutputPointsPrecision = precision;
+  this->CreateOutputArrays();
+  this->EvaluationCacheValid = false;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::SetGenerateTriangleStrips(bool generateTriangleStrips)
+{
+  if (this->GenerateTriangleStrips == generateTriangleStrips)
+    {
+    return;
+    }
+
+  this->GenerateTriangleStrips = generateTriangleStrips;
+  this->UpdateTopology();
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::CreateOutputArrays()
+{
+  vtkIdType numberOfPoints = this->GridResolution[0]*this->GridResolution[1];
+
+  // DEFAULT_PRECISION falls back to the precision of the control points
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    this->DataArray = vtkSmartPointer<vtkDataArray>::Take(vtkFloatArray::New());
+    this->NormalsArray = vtkSmartPointer<vtkDataArray>::Take(vtkFloatArray::New());
+    }
+  else
+    {
+    this->DataArray = vtkSmartPointer<vtkDataArray>::Take(vtkDoubleArray::New());
+    this->NormalsArray = vtkSmartPointer<vtkDataArray>::Take(vtkDoubleArray::New());
+    }
+
+  this->DataArray->SetNumberOfComponents(3);
+  this->DataArray->SetNumberOfTuples(numberOfPoints);
+  this->NormalsArray->SetName("Normals");
+  this->NormalsArray->SetNumberOfComponents(3);
+  this->NormalsArray->SetNumberOfTuples(numberOfPoints);
+
+  this->OutputPoints->SetData(this->DataArray);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::GetResolution(unsigned int resolution[2]) const
+{
+  resolution[0] = this->Resolution[0];
+  resolution[1] = this->Resolution[1];
+}
+
+//-------------------------------------------------------------------------------
+int vtkBezierSurfaceSource::RequestData(vtkInformation *vtkNotUsed(request),
+                                        vtkInformationVector **vtkNotUsed(inputVector),
+                                        vtkInformationVector *outputVector)
+{
+  vtkInformation *bezierSurfaceOutputInfo = outputVector->GetInformationObject(0);
+  if (bezierSurfaceOutputInfo)
+    {
+    vtkPolyData *bezierSurfaceOutput =
+      vtkPolyData::SafeDownCast(bezierSurfaceOutputInfo->Get(vtkDataObject::DATA_OBJECT()));
+    if (this->AdaptiveTessellation)
+      {
+      this->UpdateAdaptiveGridParameters();
+      }
+    this->UpdateBezierSurfacePolyData(bezierSurfaceOutput);
+
+    // The executive initializes the output before every execution, so the
+    // same cell array is attached again. It is only replaced (and its
+    // modification time changes) when UpdateTopology rebuilds it.
+    if (this->GenerateTriangleStrips)
+      {
+      bezierSurfaceOutput->SetStrips(this->Topology);
+      }
+    else
+      {
+      bezierSurfaceOutput->SetPolys(this->Topology);
+      }
+    }
+
+  return 1;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::UpdateTopology()
+{
+  this->Topology = GetGridTopology(this->GridResolution[0], this->GridResolution[1],
+                                   this->GenerateTriangleStrips);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::ComputeBinomialCoefficients()
+{
+  // Rows of Pascal's triangle, built by additions only: the coefficients are
+  // exact in double precision up to degree 56.
+  unsigned int numberOfControlPoints[2] = {this->NumberOfControlPoints[0],
+                                           this->NumberOfControlPoints[1]};
+  double *binomials[2] = {this->BinomialCoefficientsX, this->BinomialCoefficientsY};
+
+  for (int d=0; d<2; d++)
+    {
+    double *row = binomials[d];
+    std::fill(row, row+numberOfControlPoints[d], 0.0);
+    row[0] = 1.0;
+    for (unsigned int r=1; r<numberOfControlPoints[d]; r++)
+      {
+      for (unsigned int k=r; k>0; k--)
+        {
+        row[k] += row[k-1];
+        }
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::UpdateBezierSurfacePolyData(vtkPolyData *polyData)
+{
+  if (polyData == NULL)
+    {
+    return;
+    }
+
+  // The output points and normals are updated in place, so downstream
+  // filters and mappers see the same objects with a newer modification time.
+  this->MovedControlPoints.clear();
+  if (this->FindMovedControlPoints(this->MovedControlPoints))
+    {
+    this->EvaluateMovedControlPoints(this->MovedControlPoints);
+    }
+  else
+    {
+    this->EvaluateBezierSurface();
+    }
+  this->OutputPoints->Modified();
+  polyData->SetPoints(this->OutputPoints);
+  polyData->GetPointData()->SetNormals(
+    this->ComputeNormals ? this->NormalsArray.GetPointer() : nullptr);
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::ComputeBasisFunctions()
+{
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+  unsigned int xRes = this->GridResolution[0];
+  unsigned int yRes = this->GridResolution[1];
+
+  this->BasisU.resize(xRes*xGrid);
+  this->BasisV.assign(yGrid*PaddedResolution(yRes), 0.0);
+  this->DerivativeBasisU.resize(xRes*xGrid);
+  this->DerivativeBasisV.assign(yGrid*PaddedResolution(yRes), 0.0);
+  this->IntermediatePoints.resize(xRes*yGrid*3);
+  this->IntermediateDerivatives.resize(xRes*yGrid*3);
+  this->DerivativesU.resize(xRes*yRes*3);
+  this->DerivativesV.resize(xRes*yRes*3);
+
+  for (unsigned int i=0; i<xRes; i++)
+    {
+    double u = this->ParametersU[i];
+    EvaluateBernsteinPolynomials(xGrid, this->BinomialCoefficientsX, u,
+                                 &this->BasisU[i*xGrid],
+                                 &this->DerivativeBasisU[i*xGrid],
+                                 this->DeCasteljauThreshold);
+    }
+
+  // The v basis is stored transposed, so the samples of each control point
+  // are contiguous for the evaluation kernel.
+  unsigned int paddedYRes = PaddedResolution(yRes);
+  std::vector<double> basisV(yGrid);
+  std::vector<double> derivativeBasisV(yGrid);
+  for (unsigned int j=0; j<yRes; j++)
+    {
+    double v = this->ParametersV[j];
+    EvaluateBernsteinPolynomials(yGrid, this->BinomialCoefficientsY, v,
+                                 basisV.data(), derivativeBasisV.data(),
+                                 this->DeCasteljauThreshold);
+    for (unsigned int cj=0; cj<yGrid; cj++)
+      {
+      this->BasisV[cj*paddedYRes+j] = basisV[cj];
+      this->DerivativeBasisV[cj*paddedYRes+j] = derivativeBasisV[cj];
+      }
+    }
+
+  // Single precision copies for the evaluation of single precision output
+  this->BasisVSingle.assign(this->BasisV.begin(), this->BasisV.end());
+  this->DerivativeBasisVSingle.assign(this->DerivativeBasisV.begin(),
+                                      this->DerivativeBasisV.end());
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::EvaluateBezierSurface()
+{
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+
+  // Gather the control net in one contiguous block, laid out as x, y and z
+  // blocks. This is also the copy of the control points the cached surface is
+  // evaluated with.
+  unsigned int numberOfControlPoints = xGrid*yGrid;
+  const double *sourceControlPoints = this->ControlPoints->GetPointer(0);
+  std::vector<double> &controlPoints = this->EvaluatedControlPoints;
+  controlPoints.resize(numberOfControlPoints*3);
+  for (unsigned int index=0; index<numberOfControlPoints; index++)
+    {
+    for (unsigned int c=0; c<3; c++)
+      {
+      controlPoints[c*numberOfControlPoints+index] = sourceControlPoints[index*3+c];
+      }
+    }
+
+  BezierSurfaceGridBuffers buffers;
+  buffers.NumberOfControlPoints[0] = xGrid;
+  buffers.NumberOfControlPoints[1] = yGrid;
+  buffers.Resolution[0] = this->GridResolution[0];
+  buffers.Resolution[1] = this->GridResolution[1];
+  buffers.ComputeNormals = this->ComputeNormals;
+  buffers.ControlPoints = controlPoints.data();
+  buffers.BasisU = this->BasisU.data();
+  buffers.DerivativeBasisU = this->DerivativeBasisU.data();
+  buffers.IntermediatePoints = this->IntermediatePoints.data();
+  buffers.IntermediateDerivatives = this->IntermediateDerivatives.data();
+  buffers.DerivativesU = this->DerivativesU.data();
+  buffers.DerivativesV = this->DerivativesV.data();
+
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    BezierSurfaceGridEvaluation<float> evaluation;
+    static_cast<BezierSurfaceGridBuffers&>(evaluation) = buffers;
+    evaluation.BasisV = this->BasisVSingle.data();
+    evaluation.DerivativeBasisV = this->DerivativeBasisVSingle.data();
+    evaluation.Points = vtkFloatArray::SafeDownCast(this->DataArray)->GetPointer(0);
+    evaluation.Normals = vtkFloatArray::SafeDownCast(this->NormalsArray)->GetPointer(0);
+    EvaluateBezierSurfaceGrid(evaluation);
+    }
+  else
+    {
+    BezierSurfaceGridEvaluation<double> evaluation;
+    static_cast<BezierSurfaceGridBuffers&>(evaluation) = buffers;
+    evaluation.BasisV = this->BasisV.data();
+    evaluation.DerivativeBasisV = this->DerivativeBasisV.data();
+    evaluation.Points = vtkDoubleArray::SafeDownCast(this->DataArray)->GetPointer(0);
+    evaluation.Normals = vtkDoubleArray::SafeDownCast(this->NormalsArray)->GetPointer(0);
+    EvaluateBezierSurfaceGrid(evaluation);
+    }
+
+  this->EvaluationCacheValid = true;
+  this->EvaluatedNormals = this->ComputeNormals;
+  this->NumberOfIncrementalUpdates = 0;
+
+  this->DataArray->Modified();
+  this->NormalsArray->Modified();
+}
+
+//-------------------------------------------------------------------------------
+bool vtkBezierSurfaceSource::FindMovedControlPoints(std::vector<unsigned int> &movedControlPoints)
+{
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+
+  if (!this->EvaluationCacheValid ||
+      this->EvaluatedNormals != this->ComputeNormals ||
+      this->NumberOfIncrementalUpdates >= MaximumNumberOfIncrementalUpdates)
+    {
+    return false;
+    }
+
+  unsigned int numberOfControlPoints = xGrid*yGrid;
+  const double *controlPoints = this->ControlPoints->GetPointer(0);
+  const double *evaluatedControlPoints = this->EvaluatedControlPoints.data();
+
+  for (unsigned int index=0; index<numberOfControlPoints; index++)
+    {
+    const double *controlPoint = controlPoints+index*3;
+    if (controlPoint[0] != evaluatedControlPoints[index] ||
+        controlPoint[1] != evaluatedControlPoints[numberOfControlPoints+index] ||
+        controlPoint[2] != evaluatedControlPoints[2*numberOfControlPoints+index])
+      {
+      movedControlPoints.push_back(index);
+      }
+    }
+
+  // Every moved control point costs one pass over the grid, whereas the full
+  // evaluation costs about NumberOfControlPoints[1] passes.
+  return movedControlPoints.size() < yGrid;
+}
+
+//-------------------------------------------------------------------------------
+void vtkBezierSurfaceSource::EvaluateMovedControlPoints(const std::vector<unsigned int> &movedControlPoints)
+{
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    this->UpdateMovedControlPoints(
+      vtkFloatArray::SafeDownCast(this->DataArray)->GetPointer(0),
+      vtkFloatArray::SafeDownCast(this->NormalsArray)->GetPointer(0),
+      movedControlPoints);
+    }
+  else
+    {
+    this->UpdateMovedControlPoints(
+      vtkDoubleArray::SafeDownCast(this->DataArray)->GetPointer(0),
+      vtkDoubleArray::SafeDownCast(this->NormalsArray)->GetPointer(0),
+      movedControlPoints);
+    }
+
+  if (this->ComputeNormals && !movedControlPoints.empty())
+    {
+    this->NormalsArray->Modified();
+    }
+
+  this->NumberOfIncrementalUpdates++;
+  this->DataArray->Modified();
+}
+
+//-------------------------------------------------------------------------------
+template <typename Real>
+void vtkBezierSurfaceSource::UpdateMovedControlPoints(Real *surfacePoints, Real *normals,
+                                                      const std::vector<unsigned int> &movedControlPoints)
+{
+  unsigned int xGrid = this->NumberOfControlPoints[0];
+  unsigned int yGrid = this->NumberOfControlPoints[1];
+  unsigned int xRes = this->GridResolution[0];
+  unsigned int yRes = this->GridResolution[1];
+
+  unsigned int paddedYRes = PaddedResolution(yRes);
+  unsigned int numberOfControlPoints = xGrid*yGrid;
+  bool computeNormals = this->ComputeNormals;
+
+  for (unsigned int index : movedControlPoints)
+    {
+    unsigned int ci = index / yGrid;
+    unsigned int cj = index % yGrid;
+
+    const double *controlPoint = this->ControlPoints->GetPointer(index*3);
+    double *evaluatedControlPoint[3] = {
+      &this->EvaluatedControlPoints[index],
+      &this->EvaluatedControlPoints[numberOfControlPoints+index],
+      &this->EvaluatedControlPoints[2*numberOfControlPoints+index]};
+    double delta[3] = {controlPoint[0] - *evaluatedControlPoint[0],
+                       controlPoint[1] - *evaluatedControlPoint[1],
+                       controlPoint[2] - *evaluatedControlPoint[2]};
+    const double *basisV = &this->BasisV[cj*paddedYRes];
+    const double *derivativeBasisV = &this->DerivativeBasisV[cj*paddedYRes];
+
+    ForEachGridRow(xRes, yRes, [&](vtkIdType rowBegin, vtkIdType rowEnd)
+      {
+      for (vtkIdType i=rowBegin; i<rowEnd; i++)
+        {
+        double basisU = this->BasisU[i*xGrid+ci];
+        double derivativeBasisU = this->DerivativeBasisU[i*xGrid+ci];
+
+        for (unsigned int j=0; j<yRes; j++)
+          {
+          double weight = basisU * basisV[j];
+          Real *point = surfacePoints+(i*yRes+j)*3;
+          point[0] += static_cast<Real>(delta[0] * weight);
+          point[1] += static_cast<Real>(delta[1] * weight);
+          point[2] += static_cast<Real>(delta[2] * weight);
+
+          if (computeNormals)
+            {
+            double weightU = derivativeBasisU * basisV[j];
+            double weightV = basisU * derivativeBasisV[j];
+            double *derivativeU = &this->DerivativesU[(i*yRes+j)*3];
+            double *derivativeV = &this->DerivativesV[(i*yRes+j)*3];
+            derivativeU[0] += delta[0] * weightU;
+            derivativeU[1] += delta[1] * weightU;
+            derivativeU[2] += delta[2] * weightU;
+            derivativeV[0] += delta[0] * weightV;
+            derivativeV[1] += delta[1] * weightV;
+            derivativeV[2] += delta[2] * weightV;
+            }
+          }
+        }
+      });
+
+    *evaluatedControlPoint[0] = controlPoint[0];
+    *evaluatedControlPoint[1] = controlPoint[1];
+    *evaluatedControlPoint[2] = controlPoint[2];
+    }
+
+  // The normals are not linear in the control points, so they are rebuilt
+  // from the updated partial derivatives.
+  if (computeNormals && !movedControlPoints.empty())
+    {
+    vtkIdType numberOfPoints = static_cast<vtkIdType>(xRes)*yRes;
+
+    ForEachGridRow(numberOfPoints, 1, [&](vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType k=begin; k<end; k++)
+        {
+        double normal[3];
+        vtkMath::Cross(&this->DerivativesU[k*3], &this->DerivativesV[k*3], normal);
+        vtkMath::Normalize(normal);
+        normals[k*3]   = static_cast<Real>(normal[0]);
+        normals[k*3+1] = static_cast<Real>(normal[1]);
+        normals[k*3+2] = static_cast<Real>(normal[2]);
+        }
+      });
+    }
+}
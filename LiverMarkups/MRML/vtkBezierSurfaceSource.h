@@ -0,0 +1,442 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkBezierSurfaceSource.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+#ifndef __vtkBezierSurfaceSource_h
+#define __vtkBezierSurfaceSource_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+//-------------------------------------------------------------------------------
+class vtkCellArray;
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkPoints;
+class vtkPolyData;
+class vtkFloatArray;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class generates the geometry of a Bézier surface
+ * of degree \f$m+1\times n+1\f$ where \f$m\f$ and \f$n\f$ are number of control
+ * points in the respective parametric directions $u$ and \f$v\f$.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkBezierSurfaceSource : public vtkPolyDataAlgorithm
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   *
+   * @return pointer to vtkBezierSurfaceSource newly created.
+   */
+  static vtkBezierSurfaceSource *New();
+
+  vtkTypeMacro(vtkBezierSurfaceSource, vtkPolyDataAlgorithm);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set the control points.
+   *
+   * @param points pointer to vtkPoints object containing the
+   * coordinates of the control points.
+   */
+  void SetControlPoints(vtkPoints *points);
+
+  /**
+   * Set the control points from a 3-component array laid out row by row
+   * (\f$P_{00}, P_{01}, \ldots, P_{0n}, P_{10}, \ldots\f$). A vtkDoubleArray
+   * is used directly without copying it, so later in-place changes of the
+   * array (followed by its Modified()) are picked up by the source. Other
+   * array types are copied.
+   *
+   * @param points array holding at least \f$m\times n\f$ control points.
+   */
+  void SetControlPoints(vtkDataArray *points);
+
+  /**
+   * Set the control points from a caller-owned buffer of \f$m\times n\times 3\f$
+   * doubles laid out as in SetControlPoints(vtkDataArray*). The buffer is
+   * used without copying it and must outlive its use by the source; it is
+   * never freed by the source. Call this method again (or Modified()) after
+   * changing the buffer in place.
+   *
+   * @param points pointer to the control point coordinates.
+   */
+  void SetControlPoints(double *points);
+
+  /**
+   * Get the control points.
+   *
+   * @return pointer to vtkPoints object containing the coordinates of
+   * the control points.
+   */
+  vtkSmartPointer<vtkPoints> GetControlPoints() const;
+
+  /**
+   * Set the number of control points.
+   *
+   * @param m number of control points in the parametric u direction.
+   * @param n number of control points in the parametric v direction.
+   */
+  void SetNumberOfControlPoints(unsigned int m, unsigned int n);
+
+  /**
+   * Set the resolution of the Bézier surface (number of quads).
+   *
+   * @param x resolution of the surface in the parametric u direction.
+   * @param y resolution of the surface in the parametric v direction.
+   */
+  void SetResolution(unsigned int x, unsigned int y);
+
+  /**
+   * Get the resolution of the Bézier surface (number of quads).
+   *
+   * @param resolution pointer to int array containing u and v resolution.
+   */
+  void GetResolution(unsigned int *resolution) const;
+
+  /**
+   * Get thre resolution in the parametric direction u (number of quads).
+   *
+   * @return resolution in parametric direction u.
+   */
+  unsigned int GetResolutionX() const
+  {return this->Resolution[0];}
+
+  /**
+   * Get the resolution in the parametric direction v (number of quads).
+   *
+   * @return resolution in the parametric direction v.
+   */
+  unsigned int GetResolutionY() const
+  {return this->Resolution[1];}
+
+  /**
+   * Set/get whether the surface is sampled adaptively. The samples along
+   * each parametric direction are then chosen by recursive bisection of
+   * the parameter range until the control net deviates from the mesh by
+   * less than AdaptiveTolerance, so flat regions get few samples and
+   * strongly curved ones get many. The resolution becomes the maximum
+   * number of samples per direction. The samples still form a tensor
+   * grid, so the mesh has no cracks. Off by default.
+   */
+  void SetAdaptiveTessellation(bool adaptiveTessellation);
+  vtkGetMacro(AdaptiveTessellation, bool);
+  vtkBooleanMacro(AdaptiveTessellation, bool);
+
+  /**
+   * Set/get the largest deviation, in world units, between the surface and
+   * its adaptive tessellation. For a screen-space tolerance, multiply the
+   * tolerance in pixels by the size of a pixel at the surface.
+   */
+  vtkSetClampMacro(AdaptiveTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(AdaptiveTolerance, double);
+
+  /**
+   * Set/get the number of control points, in a parametric direction, from
+   * which the Bernstein polynomials are evaluated with the de Casteljau
+   * recurrence instead of the power form. The power form is faster at every
+   * degree, but its binomial coefficients are only exact up to 57 control
+   * points, which is the default threshold. The recurrence needs no binomial
+   * coefficients and is stable at any degree.
+   */
+  void SetDeCasteljauThreshold(unsigned int threshold);
+  vtkGetMacro(DeCasteljauThreshold, unsigned int);
+
+  /**
+   * Get the number of samples of the output grid in each parametric
+   * direction. This is the resolution unless adaptive tessellation is on.
+   *
+   * @param resolution pointer to int array containing u and v resolution.
+   */
+  void GetGridResolution(unsigned int *resolution) const;
+
+#if !defined(__VTK_WRAP__)
+  /**
+   * Evaluate the surface at n arbitrary parameters, independently of the
+   * output grid and without requiring an update of the pipeline. Parameters
+   * outside [0, 1] extrapolate the polynomial surface. Points are evaluated
+   * in parallel with vtkSMPTools.
+   *
+   * @param uv n (u, v) pairs.
+   * @param n number of parameter pairs.
+   * @param xyz output buffer for n points.
+   * @param dU optional output buffer for n partial derivatives along u.
+   * @param dV optional output buffer for n partial derivatives along v.
+   */
+  void EvaluatePoints(const double *uv, vtkIdType n, double *xyz,
+                      double *dU = nullptr, double *dV = nullptr) const;
+#endif
+
+  /**
+   * Array variant of EvaluatePoints. The outputs are resized to the number of
+   * parameter tuples, but are not reallocated when they are large enough, so
+   * arrays wrapping numpy buffers (numpy_support.numpy_to_vtk) are written
+   * in place.
+   *
+   * @param uv 2-component array of (u, v) parameters.
+   * @param xyz output points.
+   * @param dU optional output partial derivatives along u.
+   * @param dV optional output partial derivatives along v.
+   */
+  void EvaluatePoints(vtkDoubleArray *uv, vtkDoubleArray *xyz,
+                      vtkDoubleArray *dU = nullptr, vtkDoubleArray *dV = nullptr) const;
+
+  /**
+   * Set the control points to the default values (e.g., lying in a
+   * plane of size 1).
+   */
+  void ResetControlPoints();
+
+  /**
+   * Get the number of control poits in the parametric direction u.
+   *
+   * @return number of control points in the parametric direction u.
+   */
+  unsigned int GetNumberOfControlPointsX() const
+  {return this->NumberOfControlPoints[0];}
+
+  /**
+   * Get the number of control poits in the parametric direction v.
+   *
+   * @return number of control points in the parametric direction v.
+   */
+  unsigned int GetNumberOfControlPointsY() const
+  {return this->NumberOfControlPoints[1];}
+
+  /**
+   * Set/Get whether exact per-vertex normals are computed. The normals are
+   * obtained from the analytic partial derivatives of the surface in the same
+   * pass as the positions, so no vtkPolyDataNormals filter is needed
+   * downstream. Off by default.
+   */
+  vtkSetMacro(ComputeNormals, bool);
+  vtkGetMacro(ComputeNormals, bool);
+  vtkBooleanMacro(ComputeNormals, bool);
+
+  /**
+   * Set/get the desired precision of the output points and normals (see
+   * vtkAlgorithm::DesiredOutputPrecision). With
+   * vtkAlgorithm::SINGLE_PRECISION the surface is evaluated and stored as
+   * float, which is enough for display and is uploaded to the graphics card
+   * without conversion. vtkAlgorithm::DOUBLE_PRECISION (the default) and
+   * vtkAlgorithm::DEFAULT_PRECISION produce double precision output.
+   */
+  void SetOutputPointsPrecision(int precision);
+  vtkGetMacro(OutputPointsPrecision, int);
+
+  /**
+   * Set/get whether the surface is output as one triangle strip per row of
+   * the grid (in the strips of the output) instead of two triangles per
+   * quad (in the polys of the output). Off by default.
+   *
+   * The cells of the grid are shared by all the sources with the same
+   * resolution and mode, and must not be modified.
+   */
+  void SetGenerateTriangleStrips(bool generateTriangleStrips);
+  vtkGetMacro(GenerateTriangleStrips, bool);
+  vtkBooleanMacro(GenerateTriangleStrips, bool);
+
+  /**
+   * Modification time, including the one of the adopted control points.
+   */
+  vtkMTimeType GetMTime() override;
+
+ protected:
+  vtkBezierSurfaceSource();
+  ~vtkBezierSurfaceSource() override;
+
+  /**
+   * Function computing the Bézier surface according to the pipeline
+   * architecture of VTK.
+   *
+   * @return return code.
+   */
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+
+ private:
+  vtkBezierSurfaceSource(const vtkBezierSurfaceSource&);  // Not implemented.
+  void operator=(const vtkBezierSurfaceSource&);  // Not implemented.
+
+  /**
+   * Updates the topology of the mesh representing the Bézier
+   * surface. An effective update will happen whenever the resolution
+   * of the surface or the triangle strips mode is changed. The topology is
+   * taken from a cache shared across sources.
+   */
+  void UpdateTopology();
+
+  /**
+   * Computation of the binomial coefficients required for the
+   * computation of the Bézier surface. This function is used internally.
+   */
+  void ComputeBinomialCoefficients();
+
+  /**
+   * Computation of the Bernstein basis matrices (and their derivatives)
+   * sampled at the grid parameters. These only depend on the resolution and the number of
+   * control points, so they are cached and rebuilt only when either of
+   * them changes.
+   */
+  void ComputeBasisFunctions();
+
+  /**
+   * Computation of the tensor product surface of Bernstein basis (Bézier).
+   *
+   * @param polyData pointer to vtkPolyData which will hold the Bézier surface.
+   */
+  void UpdateBezierSurfacePolyData(vtkPolyData *polyData);
+
+  /**
+   * Evaluation of Bézier surface into the output points. The normals are
+   * evaluated as well when ComputeNormals is on.
+   */
+  void EvaluateBezierSurface();
+
+  /**
+   * Find the control points that changed since the last evaluation of the
+   * surface.
+   *
+   * @param movedControlPoints indices of the control points that changed.
+   * @return true if the cached surface can be updated incrementally.
+   */
+  bool FindMovedControlPoints(std::vector<unsigned int> &movedControlPoints);
+
+  /**
+   * Incremental update of the cached Bézier surface. Since the surface is
+   * linear in its control points, moving a control point \f$P_{ij}\f$ by
+   * \f$\Delta p\f$ shifts every sample by \f$\Delta p B_i(u) B_j(v)\f$.
+   *
+   * @param movedControlPoints indices of the control points that changed.
+   */
+  void EvaluateMovedControlPoints(const std::vector<unsigned int> &movedControlPoints);
+
+  /**
+   * Incremental update of the output points and normals, stored in the
+   * output precision.
+   *
+   * @param surfacePoints output points.
+   * @param normals output normals.
+   * @param movedControlPoints indices of the control points that changed.
+   */
+  template <typename Real>
+  void UpdateMovedControlPoints(Real *surfacePoints, Real *normals,
+                                const std::vector<unsigned int> &movedControlPoints);
+
+  /**
+   * Set the parameters sampled in each direction, rebuilding the basis
+   * functions and (if the grid size changed) the output arrays and
+   * topology. Nothing is done if the parameters did not change.
+   *
+   * @param parametersU increasing parameters in [0, 1] along u.
+   * @param parametersV increasing parameters in [0, 1] along v.
+   */
+  void SetGridParameters(const std::vector<double> &parametersU,
+                         const std::vector<double> &parametersV);
+
+  /**
+   * Computation of the adaptive grid parameters for the current control
+   * points.
+   */
+  void UpdateAdaptiveGridParameters();
+
+  /**
+   * (Re)allocation of the output points and normals arrays according to
+   * the resolution and the output precision.
+   */
+  void CreateOutputArrays();
+
+  /**
+   * Use the given array as control points, flagging the source as modified
+   * only when the array or its values changed.
+   *
+   * @param points array holding the control points.
+   */
+  void AdoptControlPoints(vtkDoubleArray *points);
+
+  unsigned int NumberOfControlPoints[2];
+  unsigned int Resolution[2];
+  unsigned int GridResolution[2];    // Number of samples of the output grid
+  std::vector<double> ParametersU;   // Sampled parameters along u
+  std::vector<double> ParametersV;   // Sampled parameters along v
+  bool AdaptiveTessellation;
+  double AdaptiveTolerance;
+  vtkSmartPointer<vtkDoubleArray> ControlPoints;        // Active control points (m*n x 3)
+  vtkSmartPointer<vtkDoubleArray> OwnedControlPoints;   // Storage for copied control points
+  vtkSmartPointer<vtkDoubleArray> WrappedControlPoints; // Wraps caller-owned buffers
+  double *BinomialCoefficientsX;
+  double *BinomialCoefficientsY;
+  std::vector<double> BasisU;        // GridResolution[0] x NumberOfControlPoints[0]
+  std::vector<double> BasisV;        // NumberOfControlPoints[1] x GridResolution[1] (padded)
+  std::vector<double> DerivativeBasisU; // dBu/du, same layout as BasisU
+  std::vector<double> DerivativeBasisV; // dBv/dv, same layout as BasisV
+  std::vector<float> BasisVSingle;   // BasisV in single precision
+  std::vector<float> DerivativeBasisVSingle; // DerivativeBasisV in single precision
+  std::vector<double> IntermediatePoints; // Bu * P: GridResolution[0] x 3 x NumberOfControlPoints[1]
+  std::vector<double> IntermediateDerivatives; // dBu/du * P, same layout as IntermediatePoints
+  std::vector<double> EvaluatedControlPoints; // control points of the cached surface (x, y, z blocks)
+  std::vector<double> DerivativesU;  // dS/du: GridResolution[0] x GridResolution[1] x 3
+  std::vector<double> DerivativesV;  // dS/dv: GridResolution[0] x GridResolution[1] x 3
+  bool EvaluationCacheValid;
+  bool EvaluatedNormals;
+  unsigned int NumberOfIncrementalUpdates;
+  bool ComputeNormals;
+  unsigned int DeCasteljauThreshold;  // Control points from which the basis uses de Casteljau
+  int OutputPointsPrecision;
+  bool GenerateTriangleStrips;
+  std::vector<unsigned int> MovedControlPoints;
+  vtkSmartPointer<vtkPoints> OutputPoints; // Persistent output points, wrapping DataArray
+  vtkSmartPointer<vtkDataArray> DataArray;
+  vtkSmartPointer<vtkDataArray> NormalsArray;
+  vtkSmartPointer<vtkCellArray> Topology;
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*==============================================================================
+
+ Distributed under the OSI-approved BSD 3-Clause License.
+
+  Copyright (c) Oslo University Hospital. All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+  * Neither the name of Oslo University Hospital nor the names
+    of Contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+#include "vtkMRMLMarkupsBSplineSurfaceNode.h"
+#include "vtkBSplineSurfaceSource.h"
+
+// MRML includes
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+
+//--------------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLMarkupsBSplineSurfaceNode);
+
+//--------------------------------------------------------------------------------
+vtkMRMLMarkupsBSplineSurfaceNode::vtkMRMLMarkupsBSplineSurfaceNode()
+  :Superclass()
+{
+  this->BSplineSurfaceSource = vtkSmartPointer<vtkBSplineSurfaceSource>::New();
+  this->BSplineSurfaceSource->ComputeNormalsOn();
+  this->BSplineSurfaceSource->SetOutputPointsPrecision(vtkAlgorithm::SINGLE_PRECISION);
+
+  this->BSplineSurfaceControlPoints = vtkSmartPointer<vtkPoints>::New();
+  this->BSplineSurfaceControlPoints->SetDataTypeToDouble();
+
+  this->ControlNetSize[0] = 0;
+  this->ControlNetSize[1] = 0;
+  this->Degree = 3;
+  this->SetControlNetSize(5, 5);
+
+  // Coarser tessellation while the control points are being dragged
+  this->SurfaceResolution = 8;
+  this->InteractionSurfaceResolution = 4;
+  this->InteractionActive = false;
+  this->UpdateBSplineSurfaceResolution();
+}
+
+//--------------------------------------------------------------------------------
+vtkMRMLMarkupsBSplineSurfaceNode::~vtkMRMLMarkupsBSplineSurfaceNode() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+
+  os << indent << "ControlNetSize: " << this->ControlNetSize[0] << ", "
+     << this->ControlNetSize[1] << "\n";
+  os << indent << "Degree: " << this->Degree << "\n";
+  os << indent << "SurfaceResolution: " << this->SurfaceResolution << "\n";
+  os << indent << "InteractionSurfaceResolution: " << this->InteractionSurfaceResolution << "\n";
+  os << indent << "InteractionActive: " << this->InteractionActive << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+
+  // The size of the net sets the number of control points the node accepts,
+  // so it is read before the superclass restores the control points
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLVectorMacro(controlNetSize, ControlNetSize, int, 2);
+  vtkMRMLReadXMLIntMacro(degree, Degree);
+  vtkMRMLReadXMLEndMacro();
+
+  Superclass::ReadXMLAttributes(atts);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLVectorMacro(controlNetSize, ControlNetSize, int, 2);
+  vtkMRMLWriteXMLIntMacro(degree, Degree);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::CopyContent(vtkMRMLNode* anyNode, bool deepCopy/*=true*/)
+{
+  MRMLNodeModifyBlocker blocker(this);
+
+  // As when reading, the size of the net goes before the control points
+  vtkMRMLCopyBeginMacro(anyNode);
+  vtkMRMLCopyVectorMacro(ControlNetSize, int, 2);
+  vtkMRMLCopyIntMacro(Degree);
+  vtkMRMLCopyEndMacro();
+
+  Superclass::CopyContent(anyNode, deepCopy);
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLMarkupsBSplineSurfaceNode::GetBSplineSurfaceOutputPort()
+{
+  return this->BSplineSurfaceSource->GetOutputPort();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::UpdateBSplineSurfaceControlPoints()
+{
+  int numberOfControlPoints = this->ControlNetSize[0]*this->ControlNetSize[1];
+  if (this->GetNumberOfControlPoints() != numberOfControlPoints)
+    {
+    return;
+    }
+
+  // vtkPoints::SetPoint does not modify the points, so the control net
+  // drawn from them is only refreshed if the change is flagged here
+  bool modified = false;
+  for (int i=0; i<numberOfControlPoints; i++)
+    {
+    double point[3];
+    double previousPoint[3];
+    this->GetNthControlPointPosition(i, point);
+    this->BSplineSurfaceControlPoints->GetPoint(i, previousPoint);
+    if (point[0] != previousPoint[0] || point[1] != previousPoint[1] ||
+        point[2] != previousPoint[2])
+      {
+      this->BSplineSurfaceControlPoints->SetPoint(i, point);
+      modified = true;
+      }
+    }
+  if (modified)
+    {
+    this->BSplineSurfaceControlPoints->Modified();
+    }
+
+  this->BSplineSurfaceSource->SetControlPoints(this->BSplineSurfaceControlPoints);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::SetControlNetSize(int m, int n)
+{
+  m = std::max(m, 2);
+  n = std::max(n, 2);
+  if (this->ControlNetSize[0] == m && this->ControlNetSize[1] == n)
+    {
+    return;
+    }
+
+  this->ControlNetSize[0] = m;
+  this->ControlNetSize[1] = n;
+  this->MaximumNumberOfControlPoints = m*n;
+  this->RequiredNumberOfControlPoints = m*n;
+  this->BSplineSurfaceControlPoints->SetNumberOfPoints(m*n);
+  this->BSplineSurfaceSource->SetNumberOfControlPoints(m, n);
+  this->BSplineSurfaceSource->SetDegree(this->Degree, this->Degree);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::SetDegree(int degree)
+{
+  degree = std::max(degree, 1);
+  if (this->Degree == degree)
+    {
+    return;
+    }
+
+  this->Degree = degree;
+  this->BSplineSurfaceSource->SetDegree(degree, degree);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::SetSurfaceResolution(int resolution)
+{
+  if (this->SurfaceResolution == resolution)
+    {
+    return;
+    }
+
+  this->SurfaceResolution = resolution;
+  this->UpdateBSplineSurfaceResolution();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::SetInteractionSurfaceResolution(int resolution)
+{
+  if (this->InteractionSurfaceResolution == resolution)
+    {
+    return;
+    }
+
+  this->InteractionSurfaceResolution = resolution;
+  this->UpdateBSplineSurfaceResolution();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::SetInteractionActive(bool active)
+{
+  if (this->InteractionActive == active)
+    {
+    return;
+    }
+
+  this->InteractionActive = active;
+  this->UpdateBSplineSurfaceResolution();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBSplineSurfaceNode::UpdateBSplineSurfaceResolution()
+{
+  int resolution = this->SurfaceResolution;
+  if (this->InteractionActive)
+    {
+    resolution = std::min(resolution, this->InteractionSurfaceResolution);
+    }
+  resolution = std::max(resolution, 1);
+
+  this->BSplineSurfaceSource->SetSpanResolution(resolution, resolution);
+}
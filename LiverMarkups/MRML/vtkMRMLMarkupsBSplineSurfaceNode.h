@@ -0,0 +1,157 @@
+/*==============================================================================
+
+ Distributed under the OSI-approved BSD 3-Clause License.
+
+  Copyright (c) Oslo University Hospital. All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+  * Neither the name of Oslo University Hospital nor the names
+    of Contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+==============================================================================*/
+
+#ifndef __vtkmrmlmarkupsbsplinesurfacenode_h_
+#define __vtkmrmlmarkupsbsplinesurfacenode_h_
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// MRML includes
+#include <vtkMRMLMarkupsNode.h>
+
+//VTK includes
+#include <vtkSmartPointer.h>
+
+//-----------------------------------------------------------------------------
+class vtkAlgorithmOutput;
+class vtkBSplineSurfaceSource;
+class vtkPoints;
+
+//-----------------------------------------------------------------------------
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsBSplineSurfaceNode
+: public vtkMRMLMarkupsNode
+{
+public:
+  static vtkMRMLMarkupsBSplineSurfaceNode* New();
+  vtkTypeMacro(vtkMRMLMarkupsBSplineSurfaceNode, vtkMRMLMarkupsNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //--------------------------------------------------------------------------------
+  // MRMLNode methods
+  //--------------------------------------------------------------------------------
+  const char* GetIcon() override {return ":/Icons/MarkupsGeneric.png";}
+  const char* GetAddIcon() override {return ":/Icons/MarkupsGenericMouseModePlace.png";}
+  const char* GetPlaceAddIcon() override {return ":/Icons/MarkupsGenericMouseModePlaceAdd.png";}
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  /// Get node XML tag name (like Volume, Model)
+  ///
+  const char* GetNodeTagName() override {return "MarkupsBSplineSurface";}
+
+  /// Get markup name
+  const char* GetMarkupType() override {return "BSplineSurface";}
+
+  /// Get markup short name
+  const char* GetDefaultNodeNamePrefix() override {return "BSS";}
+
+  /// Read node attributes from XML file. The size of the control net is
+  /// restored before the control points.
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy node content (excludes basic data, such as name and node references).
+  /// \sa vtkMRMLNode::CopyContent
+  vtkMRMLCopyContentMacro(vtkMRMLMarkupsBSplineSurfaceNode);
+  void CopyContent(vtkMRMLNode* anyNode, bool deepCopy=true) override;
+
+  /// B-spline surface evaluated from the control points, shared by all the
+  /// views displaying the node. Moving a control point only re-evaluates the
+  /// knot spans it influences.
+  vtkAlgorithmOutput* GetBSplineSurfaceOutputPort();
+
+  /// B-spline surface source of the node
+  vtkBSplineSurfaceSource* GetBSplineSurfaceSource() const {return this->BSplineSurfaceSource;}
+
+  /// Control points of the B-spline surface, in the order of the control net
+  vtkPoints* GetBSplineSurfaceControlPoints() const {return this->BSplineSurfaceControlPoints;}
+
+  /// Copy the control point positions to the B-spline surface. The surface
+  /// is only marked as modified when a position changed, so this can be
+  /// called by every view.
+  void UpdateBSplineSurfaceControlPoints();
+
+  /// Size of the control net (number of control points in each parametric
+  /// direction). The node requires as many control points as the net has.
+  void SetControlNetSize(int m, int n);
+  void SetControlNetSize(const int size[2]) {this->SetControlNetSize(size[0], size[1]);}
+  vtkGetVector2Macro(ControlNetSize, int);
+
+  /// Degree of the B-spline surface in both parametric directions
+  void SetDegree(int degree);
+  vtkGetMacro(Degree, int);
+
+  /// Number of segments per knot span of the tessellation when the surface
+  /// is not being interacted with.
+  void SetSurfaceResolution(int resolution);
+  vtkGetMacro(SurfaceResolution, int);
+
+  /// Number of segments per knot span of the tessellation while the surface
+  /// is being interacted with. The surface resolution is kept if it is
+  /// coarser.
+  void SetInteractionSurfaceResolution(int resolution);
+  vtkGetMacro(InteractionSurfaceResolution, int);
+
+  /// Switch between the interaction and the final tessellation. This is set
+  /// by the widgets when an interaction starts and ends.
+  void SetInteractionActive(bool active);
+  vtkGetMacro(InteractionActive, bool);
+
+protected:
+  vtkMRMLMarkupsBSplineSurfaceNode();
+  ~vtkMRMLMarkupsBSplineSurfaceNode() override;
+
+  void UpdateBSplineSurfaceResolution();
+
+  vtkSmartPointer<vtkBSplineSurfaceSource> BSplineSurfaceSource;
+  vtkSmartPointer<vtkPoints> BSplineSurfaceControlPoints;
+  int ControlNetSize[2];
+  int Degree;
+  int SurfaceResolution;
+  int InteractionSurfaceResolution;
+  bool InteractionActive;
+
+private:
+ vtkMRMLMarkupsBSplineSurfaceNode(const vtkMRMLMarkupsBSplineSurfaceNode&);
+ void operator=(const vtkMRMLMarkupsBSplineSurfaceNode&);
+};
+
+#endif //__vtkmrmlmarkupsbsplinesurfacenode_h_
@@ -38,13 +38,21 @@
 ==============================================================================*/
 
 #include "vtkMRMLMarkupsBezierSurfaceNode.h"
+#include "vtkBezierSurfaceCollisionDetector.h"
+#include "vtkBezierSurfaceSource.h"
 
 // MRML includes
 #include <vtkMRMLScene.h>
 
 // VTK includes
+#include <vtkDoubleArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
 
 //--------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsBezierSurfaceNode);
@@ -55,10 +63,271 @@ vtkMRMLMarkupsBezierSurfaceNode::vtkMRMLMarkupsBezierSurfaceNode()
 {
   this->MaximumNumberOfControlPoints = 16;
   this->RequiredNumberOfControlPoints = 16;
+
+  this->BezierSurfaceSource = vtkSmartPointer<vtkBezierSurfaceSource>::New();
+  this->BezierSurfaceSource->ComputeNormalsOn();
+  this->BezierSurfaceSource->SetOutputPointsPrecision(vtkAlgorithm::SINGLE_PRECISION);
+  this->BezierSurfaceSource->GenerateTriangleStripsOn();
+
+  // Control points in double precision, so the source uses them without
+  // copying them. Initially they lie in a plane of size 1.
+  this->BezierSurfaceControlPoints = this->BezierSurfaceSource->GetControlPoints();
+
+  // Coarser tessellation while the control points are being dragged; the
+  // interaction resolution is the one the surface was always drawn with
+  this->SurfaceResolution = 32;
+  this->InteractionSurfaceResolution = 10;
+  this->InteractionActive = false;
+  this->AdaptiveTessellation = false;
+  this->UpdateBezierSurfaceResolution();
+
+  this->CollisionDetector = vtkSmartPointer<vtkBezierSurfaceCollisionDetector>::New();
+  this->CollisionDetector->SetSurface(this->BezierSurfaceSource);
+  this->InteractionCollisionTimeBudget = 5.0;
+  this->TumorCollision = false;
+  this->TumorCollisionTime = 0;
+  this->UpdateCollisionTimeBudget();
 }
 
+//--------------------------------------------------------------------------------
+vtkMRMLMarkupsBezierSurfaceNode::~vtkMRMLMarkupsBezierSurfaceNode() = default;
+
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsBezierSurfaceNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
+
+  os << indent << "SurfaceResolution: " << this->SurfaceResolution << "\n";
+  os << indent << "InteractionSurfaceResolution: " << this->InteractionSurfaceResolution << "\n";
+  os << indent << "InteractionActive: " << this->InteractionActive << "\n";
+  os << indent << "AdaptiveTessellation: " << this->AdaptiveTessellation << "\n";
+  os << indent << "AdaptiveTolerance: " << this->GetAdaptiveTolerance() << "\n";
+  os << indent << "NumberOfTumorModelNodes: " << this->GetNumberOfTumorModelNodes() << "\n";
+  os << indent << "InteractionCollisionTimeBudget: " << this->InteractionCollisionTimeBudget << "\n";
+  os << indent << "TumorCollision: " << this->TumorCollision << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLMarkupsBezierSurfaceNode::GetBezierSurfaceOutputPort()
+{
+  return this->BezierSurfaceSource->GetOutputPort();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::UpdateBezierSurfaceControlPoints()
+{
+  if (this->GetNumberOfControlPoints() != 16)
+    {
+    return;
+    }
+
+  for (int i=0; i<16; i++)
+    {
+    double point[3];
+    this->GetNthControlPointPosition(i, point);
+    this->BezierSurfaceControlPoints->SetPoint(i, point);
+    }
+
+  this->BezierSurfaceSource->SetControlPoints(this->BezierSurfaceControlPoints);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetSurfaceResolution(int resolution)
+{
+  if (this->SurfaceResolution == resolution)
+    {
+    return;
+    }
+
+  this->SurfaceResolution = resolution;
+  this->UpdateBezierSurfaceResolution();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetInteractionSurfaceResolution(int resolution)
+{
+  if (this->InteractionSurfaceResolution == resolution)
+    {
+    return;
+    }
+
+  this->InteractionSurfaceResolution = resolution;
+  this->UpdateBezierSurfaceResolution();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetInteractionActive(bool active)
+{
+  if (this->InteractionActive == active)
+    {
+    return;
+    }
+
+  this->InteractionActive = active;
+  this->UpdateBezierSurfaceResolution();
+  this->UpdateCollisionTimeBudget();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetAdaptiveTessellation(bool adaptive)
+{
+  if (this->AdaptiveTessellation == adaptive)
+    {
+    return;
+    }
+
+  this->AdaptiveTessellation = adaptive;
+  this->BezierSurfaceSource->SetAdaptiveTessellation(adaptive);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetAdaptiveTolerance(double tolerance)
+{
+  if (this->GetAdaptiveTolerance() == tolerance)
+    {
+    return;
+    }
+
+  this->BezierSurfaceSource->SetAdaptiveTolerance(tolerance);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsBezierSurfaceNode::GetAdaptiveTolerance() const
+{
+  return this->BezierSurfaceSource->GetAdaptiveTolerance();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::UpdateBezierSurfaceResolution()
+{
+  int resolution = this->SurfaceResolution;
+  if (this->InteractionActive)
+    {
+    resolution = std::min(resolution, this->InteractionSurfaceResolution);
+    }
+  resolution = std::max(resolution, 2);
+
+  this->BezierSurfaceSource->SetResolution(resolution, resolution);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::AddTumorModelNode(vtkMRMLModelNode* tumorModelNode)
+{
+  if (!tumorModelNode)
+    {
+    return;
+    }
+
+  this->TumorModelNodes.push_back(tumorModelNode);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::RemoveAllTumorModelNodes()
+{
+  if (this->TumorModelNodes.empty())
+    {
+    return;
+    }
+
+  this->TumorModelNodes.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsBezierSurfaceNode::GetNumberOfTumorModelNodes() const
+{
+  return static_cast<int>(this->TumorModelNodes.size());
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLModelNode* vtkMRMLMarkupsBezierSurfaceNode::GetNthTumorModelNode(int n) const
+{
+  if (n < 0 || n >= this->GetNumberOfTumorModelNodes())
+    {
+    return nullptr;
+    }
+  return this->TumorModelNodes[n];
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::SetInteractionCollisionTimeBudget(double timeBudget)
+{
+  if (this->InteractionCollisionTimeBudget == timeBudget)
+    {
+    return;
+    }
+
+  this->InteractionCollisionTimeBudget = timeBudget;
+  this->UpdateCollisionTimeBudget();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsBezierSurfaceNode::UpdateTumorCollision()
+{
+  // The meshes of the tumor models are passed to the detector again only if
+  // one of them was replaced, so their hierarchies are kept otherwise
+  std::vector<vtkPolyData*> tumors;
+  for (const auto& tumorModelNode : this->TumorModelNodes)
+    {
+    if (tumorModelNode && tumorModelNode->GetPolyData())
+      {
+      tumors.push_back(tumorModelNode->GetPolyData());
+      }
+    }
+
+  bool tumorsChanged = (static_cast<int>(tumors.size()) != this->CollisionDetector->GetNumberOfTumors());
+  for (int i=0; !tumorsChanged && i<static_cast<int>(tumors.size()); i++)
+    {
+    tumorsChanged = (tumors[i] != this->CollisionDetector->GetTumor(i));
+    }
+  if (tumorsChanged)
+    {
+    this->CollisionDetector->RemoveAllTumors();
+    for (vtkPolyData* tumor : tumors)
+      {
+      this->CollisionDetector->AddTumor(tumor);
+      }
+    }
+
+  if (tumors.empty())
+    {
+    this->TumorCollision = false;
+    return false;
+    }
+
+  // All the views update after a change of the node, but only the first one
+  // runs a complete query. A query cut by the time budget is resumed by the
+  // following calls, as the detector keeps its search while the surface and
+  // the tumors are unchanged. The detector is part of the key since
+  // changing its time budget at the end of an interaction must finish the
+  // query.
+  vtkMTimeType collisionTime = std::max(this->BezierSurfaceSource->GetMTime(),
+                                        this->CollisionDetector->GetMTime());
+  for (vtkPolyData* tumor : tumors)
+    {
+    collisionTime = std::max(collisionTime, tumor->GetMTime());
+    }
+  if (collisionTime == this->TumorCollisionTime && this->CollisionDetector->GetQueryComplete())
+    {
+    return this->TumorCollision;
+    }
+
+  this->TumorCollision = this->CollisionDetector->CheckCollisions();
+  this->TumorCollisionTime = collisionTime;
+  return this->TumorCollision;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsBezierSurfaceNode::UpdateCollisionTimeBudget()
+{
+  // No budget when the interaction ends, so the final result is exact
+  this->CollisionDetector->SetTimeBudget(
+    this->InteractionActive ? this->InteractionCollisionTimeBudget : 0.0);
 }
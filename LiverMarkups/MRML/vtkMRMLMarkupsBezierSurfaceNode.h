@@ -47,8 +47,18 @@
 #include <vtkMRMLModelNode.h>
 
 //VTK includes
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+// STD includes
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class vtkAlgorithmOutput;
+class vtkBezierSurfaceCollisionDetector;
+class vtkBezierSurfaceSource;
+class vtkPoints;
+
 //-----------------------------------------------------------------------------
 class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsBezierSurfaceNode
 : public vtkMRMLMarkupsNode
@@ -80,9 +90,92 @@ public:
   /// \sa vtkMRMLNode::CopyContent
   vtkMRMLCopyContentDefaultMacro(vtkMRMLMarkupsBezierSurfaceNode);
 
+  /// Bezier surface evaluated from the control points. The surface is shared
+  /// by all the views displaying the node, so it is computed once per change
+  /// of the control points instead of once per view.
+  vtkAlgorithmOutput* GetBezierSurfaceOutputPort();
+
+  /// Bezier surface source of the node, e.g. to project points onto the
+  /// surface with vtkBezierSurfacePointProjector.
+  vtkBezierSurfaceSource* GetBezierSurfaceSource() const {return this->BezierSurfaceSource;}
+
+  /// Control points of the Bezier surface, in the order of the control net
+  vtkPoints* GetBezierSurfaceControlPoints() const {return this->BezierSurfaceControlPoints;}
+
+  /// Copy the control point positions to the Bezier surface. The surface is
+  /// only marked as modified when a position changed, so this can be called
+  /// by every view.
+  void UpdateBezierSurfaceControlPoints();
+
+  /// Resolution of the Bezier surface tessellation (in both parametric
+  /// directions) when the surface is not being interacted with.
+  void SetSurfaceResolution(int resolution);
+  vtkGetMacro(SurfaceResolution, int);
+
+  /// Resolution of the Bezier surface tessellation while the surface is
+  /// being interacted with. The surface resolution is kept if it is coarser.
+  void SetInteractionSurfaceResolution(int resolution);
+  vtkGetMacro(InteractionSurfaceResolution, int);
+
+  /// Switch between the interaction and the final tessellation. This is set
+  /// by the widgets when an interaction starts and ends.
+  void SetInteractionActive(bool active);
+  vtkGetMacro(InteractionActive, bool);
+
+  /// Tessellate the Bezier surface adaptively, with at most the resolution
+  /// above in each direction, and a maximum deviation from the surface of
+  /// AdaptiveTolerance (in mm).
+  void SetAdaptiveTessellation(bool adaptive);
+  vtkGetMacro(AdaptiveTessellation, bool);
+  vtkBooleanMacro(AdaptiveTessellation, bool);
+  void SetAdaptiveTolerance(double tolerance);
+  double GetAdaptiveTolerance() const;
+
+  /// Tumor models the Bezier surface is checked against for collisions
+  void AddTumorModelNode(vtkMRMLModelNode* tumorModelNode);
+  void RemoveAllTumorModelNodes();
+  int GetNumberOfTumorModelNodes() const;
+  vtkMRMLModelNode* GetNthTumorModelNode(int n) const;
+
+  /// Collision detector of the Bezier surface against the tumor models
+  vtkBezierSurfaceCollisionDetector* GetCollisionDetector() const {return this->CollisionDetector;}
+
+  /// Time budget (in ms) of a collision query while the surface is being
+  /// interacted with. A query cut by the budget is resumed by the next
+  /// update if the surface and the tumors did not change; any change
+  /// restarts it. Queries run to completion when the interaction ends.
+  void SetInteractionCollisionTimeBudget(double timeBudget);
+  vtkGetMacro(InteractionCollisionTimeBudget, double);
+
+  /// Check the Bezier surface against the tumor models, returning whether
+  /// it intersects any of them. Once a query completed, its result is
+  /// returned until the surface, the tumors or the detector change, so this
+  /// can be called by every view. A query cut by the time budget is resumed
+  /// by every call until it completes; until then the result only reflects
+  /// the part of the search done so far.
+  bool UpdateTumorCollision();
+
+  /// Result of the last collision query
+  vtkGetMacro(TumorCollision, bool);
+
 protected:
   vtkMRMLMarkupsBezierSurfaceNode();
-  ~vtkMRMLMarkupsBezierSurfaceNode() override = default;
+  ~vtkMRMLMarkupsBezierSurfaceNode() override;
+
+  void UpdateBezierSurfaceResolution();
+  void UpdateCollisionTimeBudget();
+
+  vtkSmartPointer<vtkBezierSurfaceSource> BezierSurfaceSource;
+  vtkSmartPointer<vtkPoints> BezierSurfaceControlPoints;
+  int SurfaceResolution;
+  int InteractionSurfaceResolution;
+  bool InteractionActive;
+  bool AdaptiveTessellation;
+  vtkSmartPointer<vtkBezierSurfaceCollisionDetector> CollisionDetector;
+  std::vector<vtkWeakPointer<vtkMRMLModelNode>> TumorModelNodes;
+  double InteractionCollisionTimeBudget;
+  bool TumorCollision;
+  vtkMTimeType TumorCollisionTime;
 
 private:
  vtkWeakPointer<vtkMRMLModelNode> Target;
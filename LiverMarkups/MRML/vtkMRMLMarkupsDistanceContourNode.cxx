@@ -38,13 +38,19 @@
 ==============================================================================*/
 
 #include "vtkMRMLMarkupsDistanceContourNode.h"
+#include "vtkPolyDataDistanceCutter.h"
 
 // MRML includes
 #include <vtkMRMLScene.h>
 
 // VTK includes
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
 
 //--------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsDistanceContourNode);
@@ -53,10 +59,56 @@ vtkMRMLNodeNewMacro(vtkMRMLMarkupsDistanceContourNode);
 vtkMRMLMarkupsDistanceContourNode::vtkMRMLMarkupsDistanceContourNode()
   :Superclass(), Target(nullptr)
 {
+  this->TargetCutter = vtkSmartPointer<vtkPolyDataDistanceCutter>::New();
 }
 
+//--------------------------------------------------------------------------------
+vtkMRMLMarkupsDistanceContourNode::~vtkMRMLMarkupsDistanceContourNode() = default;
+
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsDistanceContourNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
 }
+
+//----------------------------------------------------------------------------
+vtkPolyDataDistanceCutter* vtkMRMLMarkupsDistanceContourNode::GetTargetCutter() const
+{
+  return this->TargetCutter;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsDistanceContourNode::UpdateTargetCut()
+{
+  vtkPolyData* targetMesh = this->Target ? this->Target->GetPolyData() : nullptr;
+  this->TargetCutter->SetMesh(targetMesh);
+  if (!targetMesh || this->GetNumberOfControlPoints() != 2)
+    {
+    return false;
+    }
+
+  double externalPointPosition[3];
+  double referencePointPosition[3];
+  this->GetNthControlPointPosition(0, externalPointPosition);
+  this->GetNthControlPointPosition(1, referencePointPosition);
+
+  // The cutter is only modified if the control points moved, so the contour
+  // is not extracted again otherwise
+  this->TargetCutter->SetReferencePoint(referencePointPosition);
+  this->TargetCutter->SetRadius(
+    std::sqrt(vtkMath::Distance2BetweenPoints(externalPointPosition, referencePointPosition)));
+  this->TargetCutter->Update();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsDistanceContourNode::GetContourLength()
+{
+  return this->UpdateTargetCut() ? this->TargetCutter->GetContourLength() : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsDistanceContourNode::GetEnclosedArea()
+{
+  return this->UpdateTargetCut() ? this->TargetCutter->GetEnclosedArea() : 0.0;
+}
@@ -47,8 +47,12 @@
 #include <vtkMRMLModelNode.h>
 
 //VTK includes
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+//-----------------------------------------------------------------------------
+class vtkPolyDataDistanceCutter;
+
 //-----------------------------------------------------------------------------
 class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsDistanceContourNode
 : public vtkMRMLMarkupsLineNode
@@ -83,12 +87,31 @@ public:
   vtkMRMLModelNode* GetTarget() const {return this->Target;}
   void SetTarget(vtkMRMLModelNode* target) {this->Target = target; this->Modified();}
 
+  /// Cutter of the target model along the points as far from the second
+  /// (reference) control point as the first (external) one is. Its output
+  /// holds the contour polylines; call UpdateTargetCut() first.
+  vtkPolyDataDistanceCutter* GetTargetCutter() const;
+
+  /// Update the cutter with the mesh of the target and the control points,
+  /// and extract the contour if any of them changed. Moving only the external
+  /// point reuses the distances to the reference point. The control point
+  /// positions are used as coordinates of the target mesh, as the contour
+  /// shader does. Returns false if there is no target mesh or the contour
+  /// does not have two control points.
+  bool UpdateTargetCut();
+
+  /// Length of the contour and area of the target surface closer to the
+  /// reference point than the contour, or 0 if the target cannot be cut.
+  double GetContourLength();
+  double GetEnclosedArea();
+
 protected:
   vtkMRMLMarkupsDistanceContourNode();
-  ~vtkMRMLMarkupsDistanceContourNode() override = default;
+  ~vtkMRMLMarkupsDistanceContourNode() override;
 
 private:
  vtkWeakPointer<vtkMRMLModelNode> Target;
+ vtkSmartPointer<vtkPolyDataDistanceCutter> TargetCutter;
 
 private:
  vtkMRMLMarkupsDistanceContourNode(const vtkMRMLMarkupsDistanceContourNode&);
@@ -38,13 +38,17 @@
 ==============================================================================*/
 
 #include "vtkMRMLMarkupsSlicingContourNode.h"
+#include "vtkPolyDataPlaneCutter.h"
 
 // MRML includes
 #include <vtkMRMLScene.h>
 
 // VTK includes
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPolyData.h>
 
 //--------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsSlicingContourNode);
@@ -53,10 +57,66 @@ vtkMRMLNodeNewMacro(vtkMRMLMarkupsSlicingContourNode);
 vtkMRMLMarkupsSlicingContourNode::vtkMRMLMarkupsSlicingContourNode()
   :Superclass(), Target(nullptr)
 {
+  this->CutPlane = vtkSmartPointer<vtkPlane>::New();
+  this->TargetCutter = vtkSmartPointer<vtkPolyDataPlaneCutter>::New();
+  this->TargetCutter->SetPlane(this->CutPlane);
 }
 
+//--------------------------------------------------------------------------------
+vtkMRMLMarkupsSlicingContourNode::~vtkMRMLMarkupsSlicingContourNode() = default;
+
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsSlicingContourNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
 }
+
+//----------------------------------------------------------------------------
+vtkPolyDataPlaneCutter* vtkMRMLMarkupsSlicingContourNode::GetTargetCutter() const
+{
+  return this->TargetCutter;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsSlicingContourNode::UpdateTargetCut()
+{
+  vtkPolyData* targetMesh = this->Target ? this->Target->GetPolyData() : nullptr;
+  this->TargetCutter->SetMesh(targetMesh);
+  if (!targetMesh || this->GetNumberOfControlPoints() != 2)
+    {
+    return false;
+    }
+
+  double point1Position[3];
+  double point2Position[3];
+  this->GetNthControlPointPosition(0, point1Position);
+  this->GetNthControlPointPosition(1, point2Position);
+
+  double normal[3];
+  vtkMath::Subtract(point2Position, point1Position, normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+    {
+    return false;
+    }
+
+  // The plane is only modified if the control points moved, so the cut is
+  // not recomputed otherwise
+  this->CutPlane->SetOrigin((point1Position[0] + point2Position[0]) / 2.0,
+                            (point1Position[1] + point2Position[1]) / 2.0,
+                            (point1Position[2] + point2Position[2]) / 2.0);
+  this->CutPlane->SetNormal(normal);
+  this->TargetCutter->Update();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsSlicingContourNode::GetCutLength()
+{
+  return this->UpdateTargetCut() ? this->TargetCutter->GetCutLength() : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLMarkupsSlicingContourNode::GetCutArea()
+{
+  return this->UpdateTargetCut() ? this->TargetCutter->GetCutArea() : 0.0;
+}
@@ -47,8 +47,13 @@
 #include <vtkMRMLModelNode.h>
 
 //VTK includes
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+//-----------------------------------------------------------------------------
+class vtkPlane;
+class vtkPolyDataPlaneCutter;
+
 //-----------------------------------------------------------------------------
 class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsSlicingContourNode
 : public vtkMRMLMarkupsLineNode
@@ -83,12 +88,31 @@ public:
   vtkMRMLModelNode* GetTarget() const {return this->Target;}
   void SetTarget(vtkMRMLModelNode* target) {this->Target = target; this->Modified();}
 
+  /// Cutter of the target model with the plane of the contour (through the
+  /// middle of the control points, normal to the line joining them). Its
+  /// output holds the contour polylines; call UpdateTargetCut() first.
+  vtkPolyDataPlaneCutter* GetTargetCutter() const;
+
+  /// Update the cutter with the mesh of the target and the plane of the
+  /// control points, and cut the target if either changed. The control point
+  /// positions are used as coordinates of the target mesh, as the contour
+  /// shader does. Returns false if there is no target mesh or the contour
+  /// does not have two control points.
+  bool UpdateTargetCut();
+
+  /// Length of the contour and area of the cut face on the target, or 0 if
+  /// the target cannot be cut.
+  double GetCutLength();
+  double GetCutArea();
+
 protected:
   vtkMRMLMarkupsSlicingContourNode();
-  ~vtkMRMLMarkupsSlicingContourNode() override = default;
+  ~vtkMRMLMarkupsSlicingContourNode() override;
 
 private:
  vtkWeakPointer<vtkMRMLModelNode> Target;
+ vtkSmartPointer<vtkPolyDataPlaneCutter> TargetCutter;
+ vtkSmartPointer<vtkPlane> CutPlane;
 
 private:
  vtkMRMLMarkupsSlicingContourNode(const vtkMRMLMarkupsSlicingContourNode&);
@@ -0,0 +1,363 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataDistanceCutter.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkPolyDataDistanceCutter.h"
+#include "vtkPolyDataIsoLine.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Number of consecutive triangles, in the order of their smallest vertex
+// distance, sharing the largest vertex distance of the block
+const std::size_t DistanceIndexBlockSize = 64;
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+class vtkPolyDataDistanceCutter::vtkInternals
+{
+public:
+  // Triangles, rebuilt when the mesh changes
+  vtkMTimeType BuildTime = 0;           // mesh modification time at the last build
+  vtkPolyDataIsoLine IsoLine;           // triangles and iso-line of the last radius
+  std::vector<double> TriangleAreas;
+
+  // Vertex distances and triangle indices, rebuilt when the reference point
+  // or the mesh change
+  bool DistancesValid = false;
+  double ReferencePoint[3] = {0.0, 0.0, 0.0};
+  std::vector<double> Distances;
+  std::vector<vtkIdType> TrianglesByMinimum;  // triangles by smallest vertex distance
+  std::vector<double> MinimumDistances;       // smallest vertex distance, same order
+  std::vector<double> BlockMaximumDistances;  // largest vertex distance of every block
+  std::vector<double> MaximumDistances;       // largest vertex distances, sorted
+  std::vector<double> AreaPrefixSums;         // areas summed in the order of MaximumDistances
+
+  void Build(vtkPolyData *mesh);
+  void UpdateDistances(const double referencePoint[3]);
+  vtkIdType Extract(double radius, double &enclosedArea);
+};
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataDistanceCutter::vtkInternals::Build(vtkPolyData *mesh)
+{
+  this->TriangleAreas.clear();
+  this->DistancesValid = false;
+  this->BuildTime = mesh->GetMTime();
+  this->IsoLine.SetMesh(mesh);
+
+  const std::vector<double> &points = this->IsoLine.Points;
+  const std::vector<vtkIdType> &triangles = this->IsoLine.Triangles;
+  std::size_t numberOfTriangles = triangles.size()/3;
+  this->TriangleAreas.resize(numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    const double *p0 = &points[3*triangles[3*t]];
+    const double *p1 = &points[3*triangles[3*t+1]];
+    const double *p2 = &points[3*triangles[3*t+2]];
+    double edge1[3];
+    double edge2[3];
+    double cross[3];
+    vtkMath::Subtract(p1, p0, edge1);
+    vtkMath::Subtract(p2, p0, edge2);
+    vtkMath::Cross(edge1, edge2, cross);
+    this->TriangleAreas[t] = vtkMath::Norm(cross)/2.0;
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataDistanceCutter::vtkInternals::UpdateDistances(const double referencePoint[3])
+{
+  std::copy(referencePoint, referencePoint+3, this->ReferencePoint);
+  this->DistancesValid = true;
+
+  const std::vector<double> &points = this->IsoLine.Points;
+  const std::vector<vtkIdType> &triangles = this->IsoLine.Triangles;
+  vtkIdType numberOfPoints = this->IsoLine.NumberOfPoints;
+  this->Distances.resize(numberOfPoints);
+  for (vtkIdType p=0; p<numberOfPoints; p++)
+    {
+    this->Distances[p] = std::sqrt(vtkMath::Distance2BetweenPoints(&points[3*p], referencePoint));
+    }
+
+  std::size_t numberOfTriangles = this->TriangleAreas.size();
+  std::vector<double> minimumDistances(numberOfTriangles);
+  std::vector<double> maximumDistances(numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    double d0 = this->Distances[triangles[3*t]];
+    double d1 = this->Distances[triangles[3*t+1]];
+    double d2 = this->Distances[triangles[3*t+2]];
+    minimumDistances[t] = std::min(d0, std::min(d1, d2));
+    maximumDistances[t] = std::max(d0, std::max(d1, d2));
+    }
+
+  // Triangles by smallest distance, and the largest distance of every block
+  this->TrianglesByMinimum.resize(numberOfTriangles);
+  std::iota(this->TrianglesByMinimum.begin(), this->TrianglesByMinimum.end(), 0);
+  std::sort(this->TrianglesByMinimum.begin(), this->TrianglesByMinimum.end(),
+            [&](vtkIdType i, vtkIdType j) {return minimumDistances[i] < minimumDistances[j];});
+  this->MinimumDistances.resize(numberOfTriangles);
+  this->BlockMaximumDistances.assign((numberOfTriangles + DistanceIndexBlockSize - 1)/DistanceIndexBlockSize,
+                                     VTK_DOUBLE_MIN);
+  for (std::size_t i=0; i<numberOfTriangles; i++)
+    {
+    vtkIdType t = this->TrianglesByMinimum[i];
+    this->MinimumDistances[i] = minimumDistances[t];
+    double &blockMaximum = this->BlockMaximumDistances[i/DistanceIndexBlockSize];
+    blockMaximum = std::max(blockMaximum, maximumDistances[t]);
+    }
+
+  // Areas summed by largest distance
+  std::vector<vtkIdType> trianglesByMaximum(numberOfTriangles);
+  std::iota(trianglesByMaximum.begin(), trianglesByMaximum.end(), 0);
+  std::sort(trianglesByMaximum.begin(), trianglesByMaximum.end(),
+            [&](vtkIdType i, vtkIdType j) {return maximumDistances[i] < maximumDistances[j];});
+  this->MaximumDistances.resize(numberOfTriangles);
+  this->AreaPrefixSums.resize(numberOfTriangles+1);
+  this->AreaPrefixSums[0] = 0.0;
+  for (std::size_t i=0; i<numberOfTriangles; i++)
+    {
+    vtkIdType t = trianglesByMaximum[i];
+    this->MaximumDistances[i] = maximumDistances[t];
+    this->AreaPrefixSums[i+1] = this->AreaPrefixSums[i] + this->TriangleAreas[t];
+    }
+}
+
+//-------------------------------------------------------------------------------
+vtkIdType vtkPolyDataDistanceCutter::vtkInternals::Extract(double radius, double &enclosedArea)
+{
+  this->IsoLine.Reset();
+
+  // Vertices closer than the radius are inside, so a triangle is crossed if
+  // its smallest distance is below the radius and its largest is not.
+  // Triangles entirely inside count with their full area.
+  std::size_t numberOfInsideTriangles = static_cast<std::size_t>(
+    std::lower_bound(this->MaximumDistances.begin(), this->MaximumDistances.end(), radius) -
+    this->MaximumDistances.begin());
+  enclosedArea = this->AreaPrefixSums.empty() ? 0.0 : this->AreaPrefixSums[numberOfInsideTriangles];
+
+  std::size_t numberOfCandidates = static_cast<std::size_t>(
+    std::lower_bound(this->MinimumDistances.begin(), this->MinimumDistances.end(), radius) -
+    this->MinimumDistances.begin());
+
+  vtkIdType numberOfVisitedTriangles = 0;
+  for (std::size_t block=0; block*DistanceIndexBlockSize < numberOfCandidates; block++)
+    {
+    if (this->BlockMaximumDistances[block] < radius)
+      {
+      continue;
+      }
+
+    std::size_t end = std::min((block+1)*DistanceIndexBlockSize, numberOfCandidates);
+    for (std::size_t i=block*DistanceIndexBlockSize; i<end; i++)
+      {
+      numberOfVisitedTriangles++;
+      vtkIdType t = this->TrianglesByMinimum[i];
+      const vtkIdType *ids = &this->IsoLine.Triangles[3*t];
+      double d[3];
+      bool outside[3];
+      int numberOfInsideVertices = 0;
+      for (int v=0; v<3; v++)
+        {
+        d[v] = this->Distances[ids[v]] - radius;
+        outside[v] = (d[v] >= 0.0);
+        numberOfInsideVertices += outside[v] ? 0 : 1;
+        }
+      if (numberOfInsideVertices == 3)
+        {
+        continue;
+        }
+
+      // Part of the triangle inside: the corner cut off at the lone inside
+      // (or outside) vertex, whose sides are the fractions of the edges
+      // before the crossings
+      for (int v=0; v<3; v++)
+        {
+        if (outside[v] == (numberOfInsideVertices == 1))
+          {
+          continue;
+          }
+        int w1 = (v + 1) % 3;
+        int w2 = (v + 2) % 3;
+        double corner = this->TriangleAreas[t]*(d[v]/(d[v] - d[w1]))*(d[v]/(d[v] - d[w2]));
+        enclosedArea += (numberOfInsideVertices == 1) ? corner : this->TriangleAreas[t] - corner;
+        }
+
+      // The segment goes from the crossing of the edge leaving the outside
+      // to the one of the edge entering it, following the winding
+      this->IsoLine.InsertTriangle(ids, d);
+      }
+    }
+
+  return numberOfVisitedTriangles;
+}
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkPolyDataDistanceCutter);
+
+//-------------------------------------------------------------------------------
+vtkPolyDataDistanceCutter::vtkPolyDataDistanceCutter()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->Internals = new vtkInternals;
+  this->ReferencePoint[0] = this->ReferencePoint[1] = this->ReferencePoint[2] = 0.0;
+  this->Radius = 0.0;
+  this->ContourLength = 0.0;
+  this->EnclosedArea = 0.0;
+  this->NumberOfVisitedTriangles = 0;
+}
+
+//-------------------------------------------------------------------------------
+vtkPolyDataDistanceCutter::~vtkPolyDataDistanceCutter()
+{
+  delete this->Internals;
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataDistanceCutter::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mesh: " << this->Mesh.GetPointer() << "\n";
+  os << indent << "Reference Point: (" << this->ReferencePoint[0] << ", "
+     << this->ReferencePoint[1] << ", " << this->ReferencePoint[2] << ")\n";
+  os << indent << "Radius: " << this->Radius << "\n";
+  os << indent << "Contour Length: " << this->ContourLength << "\n";
+  os << indent << "Enclosed Area: " << this->EnclosedArea << "\n";
+  os << indent << "Number Of Visited Triangles: " << this->NumberOfVisitedTriangles << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataDistanceCutter::SetMesh(vtkPolyData *mesh)
+{
+  if (this->Mesh == mesh)
+    {
+    return;
+    }
+
+  this->Mesh = mesh;
+  this->Internals->BuildTime = 0;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkPolyData *vtkPolyDataDistanceCutter::GetMesh() const
+{
+  return this->Mesh;
+}
+
+//-------------------------------------------------------------------------------
+vtkMTimeType vtkPolyDataDistanceCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Mesh)
+    {
+    mTime = std::max(mTime, this->Mesh->GetMTime());
+    }
+  return mTime;
+}
+
+//-------------------------------------------------------------------------------
+int vtkPolyDataDistanceCutter::RequestData(vtkInformation *vtkNotUsed(request),
+                                           vtkInformationVector **vtkNotUsed(inputVector),
+                                           vtkInformationVector *outputVector)
+{
+  vtkInformation *outputInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(outputInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!output)
+    {
+    return 0;
+    }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkCellArray> lines;
+  output->SetPoints(points);
+  output->SetLines(lines);
+
+  this->ContourLength = 0.0;
+  this->EnclosedArea = 0.0;
+  this->NumberOfVisitedTriangles = 0;
+
+  if (!this->Mesh)
+    {
+    return 1;
+    }
+
+  if (this->Internals->BuildTime != this->Mesh->GetMTime())
+    {
+    this->Internals->Build(this->Mesh);
+    }
+
+  // Distances are kept while only the radius changes
+  if (!this->Internals->DistancesValid ||
+      !std::equal(this->ReferencePoint, this->ReferencePoint+3, this->Internals->ReferencePoint))
+    {
+    this->Internals->UpdateDistances(this->ReferencePoint);
+    }
+
+  this->NumberOfVisitedTriangles = this->Internals->Extract(this->Radius, this->EnclosedArea);
+
+  const std::vector<double> &crossings = this->Internals->IsoLine.Crossings;
+  const std::vector<vtkIdType> &segments = this->Internals->IsoLine.Segments;
+  for (std::size_t s=0; s<segments.size(); s+=2)
+    {
+    this->ContourLength +=
+      std::sqrt(vtkMath::Distance2BetweenPoints(&crossings[3*segments[s]], &crossings[3*segments[s+1]]));
+    }
+
+  this->Internals->IsoLine.GetPolyLines(points, lines);
+
+  return 1;
+}
@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataDistanceCutter.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkPolyDataDistanceCutter_h
+#define __vtkPolyDataDistanceCutter_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+//-------------------------------------------------------------------------------
+class vtkPolyData;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class extracts the iso-line of a triangle mesh (e.g. the liver
+ * parenchyma) at a given distance from a reference point, together with its
+ * length and the area of the surface closer to the reference point.
+ *
+ * The distance to the reference point is computed at the vertices and
+ * interpolated linearly over the triangles, and the iso-line is extracted
+ * by marching triangles. The distance contour shader evaluates the exact
+ * distance at every fragment, so the shaded contour is where the surface
+ * meets the sphere of the given radius. The iso-line is the piecewise-linear
+ * (chordal) approximation of that contour, with its crossings on the mesh
+ * edges; its length and enclosed area converge to the shaded ones as the
+ * mesh is refined. The vertex distances are cached and only recomputed when
+ * the reference point or the mesh change. With them, the triangles are
+ * indexed twice:
+ *
+ * - sorted by their smallest vertex distance, in blocks that store the
+ *   largest vertex distance of their triangles. Only triangles whose range
+ *   of distances spans the radius are crossed by the iso-line; they are
+ *   found by a binary search and a scan of the blocks that can hold them.
+ * - sorted by their largest vertex distance, with the prefix sums of their
+ *   areas. The area of the triangles lying entirely within the radius is
+ *   then a binary search away, and only the crossed triangles are clipped.
+ *
+ * Changing only the radius (moving the external point of a distance contour)
+ * therefore touches the crossed triangles and a few blocks, without
+ * computing any distance. Crossings are keyed by the mesh edge they lie on,
+ * and segments are oriented by the winding of their triangle, so they chain
+ * into polylines as in vtkPolyDataPlaneCutter.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkPolyDataDistanceCutter : public vtkPolyDataAlgorithm
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkPolyDataDistanceCutter newly created.
+   */
+  static vtkPolyDataDistanceCutter *New();
+
+  vtkTypeMacro(vtkPolyDataDistanceCutter, vtkPolyDataAlgorithm);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set/get the mesh to cut. Polygons and triangle strips are used.
+   */
+  void SetMesh(vtkPolyData *mesh);
+  vtkPolyData *GetMesh() const;
+
+  /**
+   * Set/get the point the distances are measured from.
+   */
+  vtkSetVector3Macro(ReferencePoint, double);
+  vtkGetVector3Macro(ReferencePoint, double);
+
+  /**
+   * Set/get the distance of the iso-line to the reference point.
+   */
+  vtkSetClampMacro(Radius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Radius, double);
+
+  /**
+   * Get the total length of the iso-line polylines.
+   */
+  vtkGetMacro(ContourLength, double);
+
+  /**
+   * Get the area of the surface closer to the reference point than Radius.
+   */
+  vtkGetMacro(EnclosedArea, double);
+
+  /**
+   * Get the number of triangles tested against the radius by the last
+   * extraction.
+   */
+  vtkGetMacro(NumberOfVisitedTriangles, vtkIdType);
+
+  /**
+   * Get the modification time, including the one of the mesh.
+   */
+  vtkMTimeType GetMTime() override;
+
+ protected:
+  vtkPolyDataDistanceCutter();
+  ~vtkPolyDataDistanceCutter() override;
+
+  /**
+   * Extract the iso-line, its length and the enclosed area.
+   */
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+
+ private:
+  vtkPolyDataDistanceCutter(const vtkPolyDataDistanceCutter&);  // Not implemented.
+  void operator=(const vtkPolyDataDistanceCutter&);  // Not implemented.
+
+  class vtkInternals;
+  vtkInternals *Internals;
+
+  vtkSmartPointer<vtkPolyData> Mesh;
+  double ReferencePoint[3];
+  double Radius;
+
+  double ContourLength;
+  double EnclosedArea;
+  vtkIdType NumberOfVisitedTriangles;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataIsoLine.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkPolyDataIsoLine.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataIsoLine::SetMesh(vtkPolyData *mesh)
+{
+  this->Reset();
+  this->Points.clear();
+  this->Triangles.clear();
+  this->NumberOfPoints = 0;
+
+  vtkPoints *points = mesh->GetPoints();
+  if (!points)
+    {
+    return;
+    }
+  this->NumberOfPoints = points->GetNumberOfPoints();
+  this->Points.resize(3*this->NumberOfPoints);
+  for (vtkIdType p=0; p<this->NumberOfPoints; p++)
+    {
+    points->GetPoint(p, &this->Points[3*p]);
+    }
+
+  vtkIdType numberOfCellPoints;
+  const vtkIdType *cellPoints;
+  vtkCellArray *polys = mesh->GetPolys();
+  for (vtkIdType c=0; polys && c<polys->GetNumberOfCells(); c++)
+    {
+    polys->GetCellAtId(c, numberOfCellPoints, cellPoints);
+    for (vtkIdType k=1; k+1<numberOfCellPoints; k++)
+      {
+      this->Triangles.insert(this->Triangles.end(), {cellPoints[0], cellPoints[k], cellPoints[k+1]});
+      }
+    }
+  vtkCellArray *strips = mesh->GetStrips();
+  for (vtkIdType c=0; strips && c<strips->GetNumberOfCells(); c++)
+    {
+    strips->GetCellAtId(c, numberOfCellPoints, cellPoints);
+    for (vtkIdType k=0; k+2<numberOfCellPoints; k++)
+      {
+      // Every other triangle of a strip is wound the other way
+      if (k % 2 == 0)
+        {
+        this->Triangles.insert(this->Triangles.end(), {cellPoints[k], cellPoints[k+1], cellPoints[k+2]});
+        }
+      else
+        {
+        this->Triangles.insert(this->Triangles.end(), {cellPoints[k+1], cellPoints[k], cellPoints[k+2]});
+        }
+      }
+    }
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataIsoLine::Reset()
+{
+  this->EdgeCrossings.clear();
+  this->Crossings.clear();
+  this->Segments.clear();
+}
+
+//-------------------------------------------------------------------------------
+vtkIdType vtkPolyDataIsoLine::InsertCrossing(vtkIdType a, vtkIdType b, double va, double vb)
+{
+  // Both triangles sharing the edge find the same crossing, computed from the
+  // end points in the same order
+  if (a > b)
+    {
+    std::swap(a, b);
+    std::swap(va, vb);
+    }
+  vtkTypeUInt64 key = static_cast<vtkTypeUInt64>(a)*static_cast<vtkTypeUInt64>(this->NumberOfPoints) +
+    static_cast<vtkTypeUInt64>(b);
+  auto inserted = this->EdgeCrossings.insert(
+    std::make_pair(key, static_cast<vtkIdType>(this->Crossings.size()/3)));
+  if (inserted.second)
+    {
+    double t = va/(va - vb);
+    const double *pa = &this->Points[3*a];
+    const double *pb = &this->Points[3*b];
+    for (int k=0; k<3; k++)
+      {
+      this->Crossings.push_back(pa[k] + t*(pb[k] - pa[k]));
+      }
+    }
+  return inserted.first->second;
+}
+
+//-------------------------------------------------------------------------------
+bool vtkPolyDataIsoLine::InsertTriangle(const vtkIdType ids[3], const double values[3])
+{
+  bool positive[3];
+  for (int v=0; v<3; v++)
+    {
+    positive[v] = (values[v] >= 0.0);
+    }
+  if (positive[0] == positive[1] && positive[1] == positive[2])
+    {
+    return false;
+    }
+
+  vtkIdType start = -1;
+  vtkIdType end = -1;
+  for (int v=0; v<3; v++)
+    {
+    int w = (v + 1) % 3;
+    if (positive[v] && !positive[w])
+      {
+      start = this->InsertCrossing(ids[v], ids[w], values[v], values[w]);
+      }
+    else if (!positive[v] && positive[w])
+      {
+      end = this->InsertCrossing(ids[v], ids[w], values[v], values[w]);
+      }
+    }
+  this->Segments.push_back(start);
+  this->Segments.push_back(end);
+  return true;
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataIsoLine::GetPolyLines(vtkPoints *points, vtkCellArray *lines) const
+{
+  vtkIdType numberOfCrossings = static_cast<vtkIdType>(this->Crossings.size()/3);
+  vtkNew<vtkDoubleArray> coordinates;
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetNumberOfTuples(numberOfCrossings);
+  std::copy(this->Crossings.begin(), this->Crossings.end(), coordinates->GetPointer(0));
+  points->SetData(coordinates);
+
+  std::vector<vtkIdType> next(numberOfCrossings, -1);
+  std::vector<bool> hasPrevious(numberOfCrossings, false);
+  for (std::size_t s=0; s<this->Segments.size(); s+=2)
+    {
+    next[this->Segments[s]] = this->Segments[s+1];
+    hasPrevious[this->Segments[s+1]] = true;
+    }
+
+  std::vector<bool> visited(numberOfCrossings, false);
+  std::vector<vtkIdType> polyline;
+  auto trace = [&](vtkIdType start)
+    {
+    polyline.clear();
+    vtkIdType current = start;
+    while (current >= 0 && !visited[current])
+      {
+      visited[current] = true;
+      polyline.push_back(current);
+      current = next[current];
+      }
+    if (current == start)
+      {
+      polyline.push_back(start);
+      }
+    if (polyline.size() > 1)
+      {
+      lines->InsertNextCell(static_cast<vtkIdType>(polyline.size()), polyline.data());
+      }
+    };
+
+  for (vtkIdType c=0; c<numberOfCrossings; c++)
+    {
+    if (!hasPrevious[c] && !visited[c])
+      {
+      trace(c);
+      }
+    }
+  for (vtkIdType c=0; c<numberOfCrossings; c++)
+    {
+    if (!visited[c])
+      {
+      trace(c);
+      }
+    }
+}
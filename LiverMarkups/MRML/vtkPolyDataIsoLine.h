@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataIsoLine.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkPolyDataIsoLine_h
+#define __vtkPolyDataIsoLine_h
+
+// VTK includes
+#include <vtkType.h>
+
+// STD includes
+#include <unordered_map>
+#include <vector>
+
+//-------------------------------------------------------------------------------
+class vtkCellArray;
+class vtkPoints;
+class vtkPolyData;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief Internal helper of vtkPolyDataPlaneCutter and
+ * vtkPolyDataDistanceCutter, which extract the iso-line of a scalar field
+ * sampled at the vertices of a triangle mesh by marching triangles.
+ *
+ * It holds the triangles of the mesh and the iso-line being extracted.
+ * Crossings are keyed by the mesh edge they lie on, so the triangles sharing
+ * an edge share its crossing. Segments are oriented by the winding of their
+ * triangle: neighbouring triangles run along their shared edge in opposite
+ * directions, so the end of one segment is the start of the next and the
+ * segments chain into polylines without any search.
+ *
+ * This class is not wrapped and is not part of the interface of the kit.
+ */
+class vtkPolyDataIsoLine
+{
+ public:
+  /**
+   * Copy the points of the mesh in double precision and split its polygons
+   * (in fans) and triangle strips in triangles, keeping the winding of the
+   * cells. The last iso-line is removed.
+   */
+  void SetMesh(vtkPolyData *mesh);
+
+  /**
+   * Remove the crossings and segments of the last iso-line.
+   */
+  void Reset();
+
+  /**
+   * Add the segment of the iso-line crossing a triangle, given the value of
+   * the field less the iso-value at its vertices. Vertices with non-negative
+   * values are on the positive side, and the segment goes from the crossing
+   * of the edge leaving the positive side to the one of the edge entering
+   * it. Triangles on one side only are ignored.
+   *
+   * @return true if the triangle is crossed by the iso-line.
+   */
+  bool InsertTriangle(const vtkIdType ids[3], const double values[3]);
+
+  /**
+   * Copy the crossings into points and chain the segments into polylines.
+   * Open polylines start at crossings no segment ends at (boundary of an
+   * open mesh); the remaining segments form closed polylines.
+   */
+  void GetPolyLines(vtkPoints *points, vtkCellArray *lines) const;
+
+  // Mesh
+  vtkIdType NumberOfPoints = 0;
+  std::vector<double> Points;          // mesh points in double precision
+  std::vector<vtkIdType> Triangles;    // 3 point ids per triangle
+
+  // Iso-line
+  std::unordered_map<vtkTypeUInt64, vtkIdType> EdgeCrossings; // edge key -> crossing id
+  std::vector<double> Crossings;       // 3 coordinates per crossing
+  std::vector<vtkIdType> Segments;     // start and end crossing of every segment
+
+ private:
+  vtkIdType InsertCrossing(vtkIdType a, vtkIdType b, double va, double vb);
+};
+
+#endif
@@ -0,0 +1,410 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataPlaneCutter.cxx
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#include "vtkPolyDataPlaneCutter.h"
+#include "vtkPolyDataIsoLine.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//-------------------------------------------------------------------------------
+// Node of the bounding volume hierarchy over the triangles of the mesh
+struct MeshHierarchyNode
+{
+  double Center[3];    // center of the box
+  double HalfSize[3];  // half the size of the box along each axis
+  int Children[2];     // -1 for leaves
+  std::size_t First;   // first triangle of a leaf
+  std::size_t Count;   // number of triangles of a leaf
+};
+
+const std::size_t MeshHierarchyLeafSize = 8;
+
+//-------------------------------------------------------------------------------
+// Signed distance of x to the plane through origin with the unit normal
+inline double SignedDistance(const double normal[3], const double origin[3], const double x[3])
+{
+  return normal[0]*(x[0] - origin[0]) + normal[1]*(x[1] - origin[1]) + normal[2]*(x[2] - origin[2]);
+}
+
+} // end anonymous namespace
+
+//-------------------------------------------------------------------------------
+class vtkPolyDataPlaneCutter::vtkInternals
+{
+public:
+  // Triangles and hierarchy, rebuilt when the mesh changes. The triangles
+  // are kept in the order of the leaves.
+  vtkMTimeType BuildTime = 0;          // mesh modification time at the last build
+  vtkPolyDataIsoLine IsoLine;          // triangles and contour of the last plane
+  std::vector<MeshHierarchyNode> Nodes;
+  std::vector<int> Stack;
+
+  void Build(vtkPolyData *mesh);
+  vtkIdType Cut(const double origin[3], const double normal[3]);
+
+private:
+  int BuildNode(std::vector<std::size_t> &order, const std::vector<double> &centers,
+                std::size_t first, std::size_t count);
+};
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataPlaneCutter::vtkInternals::Build(vtkPolyData *mesh)
+{
+  this->Nodes.clear();
+  this->BuildTime = mesh->GetMTime();
+  this->IsoLine.SetMesh(mesh);
+
+  const std::vector<double> &points = this->IsoLine.Points;
+  std::vector<vtkIdType> &triangles = this->IsoLine.Triangles;
+  std::size_t numberOfTriangles = triangles.size()/3;
+  if (numberOfTriangles == 0)
+    {
+    return;
+    }
+
+  std::vector<double> centers(3*numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    for (int k=0; k<3; k++)
+      {
+      centers[3*t+k] = (points[3*triangles[3*t]+k] + points[3*triangles[3*t+1]+k] +
+                        points[3*triangles[3*t+2]+k])/3.0;
+      }
+    }
+  std::vector<std::size_t> order(numberOfTriangles);
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    order[t] = t;
+    }
+  this->Nodes.reserve(2*numberOfTriangles/MeshHierarchyLeafSize + 1);
+  this->BuildNode(order, centers, 0, numberOfTriangles);
+
+  // Triangles in the order of the leaves
+  std::vector<vtkIdType> leafTriangles(triangles.size());
+  for (std::size_t t=0; t<numberOfTriangles; t++)
+    {
+    std::copy(&triangles[3*order[t]], &triangles[3*order[t]]+3, &leafTriangles[3*t]);
+    }
+  triangles.swap(leafTriangles);
+}
+
+//-------------------------------------------------------------------------------
+int vtkPolyDataPlaneCutter::vtkInternals::BuildNode(std::vector<std::size_t> &order,
+                                                    const std::vector<double> &centers,
+                                                    std::size_t first, std::size_t count)
+{
+  const std::vector<double> &points = this->IsoLine.Points;
+  const std::vector<vtkIdType> &triangles = this->IsoLine.Triangles;
+  int index = static_cast<int>(this->Nodes.size());
+  this->Nodes.push_back(MeshHierarchyNode());
+  double bounds[6];
+  double centerBounds[6];
+  for (int k=0; k<3; k++)
+    {
+    bounds[2*k] = centerBounds[2*k] = VTK_DOUBLE_MAX;
+    bounds[2*k+1] = centerBounds[2*k+1] = VTK_DOUBLE_MIN;
+    }
+  for (std::size_t t=first; t<first+count; t++)
+    {
+    for (int v=0; v<3; v++)
+      {
+      const double *point = &points[3*triangles[3*order[t]+v]];
+      for (int k=0; k<3; k++)
+        {
+        bounds[2*k] = std::min(bounds[2*k], point[k]);
+        bounds[2*k+1] = std::max(bounds[2*k+1], point[k]);
+        }
+      }
+    for (int k=0; k<3; k++)
+      {
+      centerBounds[2*k] = std::min(centerBounds[2*k], centers[3*order[t]+k]);
+      centerBounds[2*k+1] = std::max(centerBounds[2*k+1], centers[3*order[t]+k]);
+      }
+    }
+
+  MeshHierarchyNode node;
+  for (int k=0; k<3; k++)
+    {
+    node.Center[k] = (bounds[2*k] + bounds[2*k+1])/2.0;
+    node.HalfSize[k] = (bounds[2*k+1] - bounds[2*k])/2.0;
+    }
+  node.First = first;
+  node.Count = count;
+  node.Children[0] = node.Children[1] = -1;
+
+  if (count > MeshHierarchyLeafSize)
+    {
+    // Median split along the longest axis of the triangle centers
+    int axis = 0;
+    for (int k=1; k<3; k++)
+      {
+      if (centerBounds[2*k+1] - centerBounds[2*k] > centerBounds[2*axis+1] - centerBounds[2*axis])
+        {
+        axis = k;
+        }
+      }
+    std::size_t half = count/2;
+    std::nth_element(order.begin()+first, order.begin()+first+half, order.begin()+first+count,
+                     [&](std::size_t i, std::size_t j) {return centers[3*i+axis] < centers[3*j+axis];});
+    node.Children[0] = this->BuildNode(order, centers, first, half);
+    node.Children[1] = this->BuildNode(order, centers, first+half, count-half);
+    }
+
+  this->Nodes[index] = node;
+  return index;
+}
+
+//-------------------------------------------------------------------------------
+vtkIdType vtkPolyDataPlaneCutter::vtkInternals::Cut(const double origin[3], const double normal[3])
+{
+  this->IsoLine.Reset();
+  if (this->Nodes.empty())
+    {
+    return 0;
+    }
+
+  // Slightly enlarged boxes, so rounding never rejects a node holding a
+  // vertex found on the other side of the plane
+  const double margin = 1e-9;
+
+  vtkIdType numberOfVisitedTriangles = 0;
+  this->Stack.clear();
+  this->Stack.push_back(0);
+  while (!this->Stack.empty())
+    {
+    const MeshHierarchyNode &node = this->Nodes[this->Stack.back()];
+    this->Stack.pop_back();
+
+    double distance = SignedDistance(normal, origin, node.Center);
+    double radius = std::fabs(normal[0])*node.HalfSize[0] + std::fabs(normal[1])*node.HalfSize[1] +
+      std::fabs(normal[2])*node.HalfSize[2];
+    radius += margin*(radius + std::fabs(distance)) + margin;
+    if (distance > radius || distance < -radius)
+      {
+      continue;
+      }
+
+    if (node.Children[0] >= 0)
+      {
+      this->Stack.push_back(node.Children[0]);
+      this->Stack.push_back(node.Children[1]);
+      continue;
+      }
+
+    numberOfVisitedTriangles += static_cast<vtkIdType>(node.Count);
+
+    // Vertices lying on the plane count as being on its positive side
+    for (std::size_t t=node.First; t<node.First+node.Count; t++)
+      {
+      const vtkIdType *ids = &this->IsoLine.Triangles[3*t];
+      double d[3];
+      for (int v=0; v<3; v++)
+        {
+        d[v] = SignedDistance(normal, origin, &this->IsoLine.Points[3*ids[v]]);
+        }
+      this->IsoLine.InsertTriangle(ids, d);
+      }
+    }
+
+  return numberOfVisitedTriangles;
+}
+
+//-------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkPolyDataPlaneCutter);
+
+//-------------------------------------------------------------------------------
+vtkPolyDataPlaneCutter::vtkPolyDataPlaneCutter()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->Internals = new vtkInternals;
+  this->CutLength = 0.0;
+  this->CutArea = 0.0;
+  this->NumberOfVisitedTriangles = 0;
+}
+
+//-------------------------------------------------------------------------------
+vtkPolyDataPlaneCutter::~vtkPolyDataPlaneCutter()
+{
+  delete this->Internals;
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataPlaneCutter::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mesh: " << this->Mesh.GetPointer() << "\n";
+  os << indent << "Plane: " << this->Plane.GetPointer() << "\n";
+  os << indent << "Cut Length: " << this->CutLength << "\n";
+  os << indent << "Cut Area: " << this->CutArea << "\n";
+  os << indent << "Number Of Visited Triangles: " << this->NumberOfVisitedTriangles << "\n";
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataPlaneCutter::SetMesh(vtkPolyData *mesh)
+{
+  if (this->Mesh == mesh)
+    {
+    return;
+    }
+
+  this->Mesh = mesh;
+  this->Internals->BuildTime = 0;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkPolyData *vtkPolyDataPlaneCutter::GetMesh() const
+{
+  return this->Mesh;
+}
+
+//-------------------------------------------------------------------------------
+void vtkPolyDataPlaneCutter::SetPlane(vtkPlane *plane)
+{
+  if (this->Plane == plane)
+    {
+    return;
+    }
+
+  this->Plane = plane;
+  this->Modified();
+}
+
+//-------------------------------------------------------------------------------
+vtkPlane *vtkPolyDataPlaneCutter::GetPlane() const
+{
+  return this->Plane;
+}
+
+//-------------------------------------------------------------------------------
+vtkMTimeType vtkPolyDataPlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Mesh)
+    {
+    mTime = std::max(mTime, this->Mesh->GetMTime());
+    }
+  if (this->Plane)
+    {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+    }
+  return mTime;
+}
+
+//-------------------------------------------------------------------------------
+int vtkPolyDataPlaneCutter::RequestData(vtkInformation *vtkNotUsed(request),
+                                        vtkInformationVector **vtkNotUsed(inputVector),
+                                        vtkInformationVector *outputVector)
+{
+  vtkInformation *outputInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(outputInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!output)
+    {
+    return 0;
+    }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkCellArray> lines;
+  output->SetPoints(points);
+  output->SetLines(lines);
+
+  this->CutLength = 0.0;
+  this->CutArea = 0.0;
+  this->NumberOfVisitedTriangles = 0;
+
+  if (!this->Mesh || !this->Plane)
+    {
+    return 1;
+    }
+
+  double origin[3];
+  double normal[3];
+  this->Plane->GetOrigin(origin);
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+    {
+    vtkErrorMacro("RequestData: the cutting plane has no normal.");
+    return 0;
+    }
+
+  if (this->Internals->BuildTime != this->Mesh->GetMTime())
+    {
+    this->Internals->Build(this->Mesh);
+    }
+
+  this->NumberOfVisitedTriangles = this->Internals->Cut(origin, normal);
+
+  // Length, and area as the sum of the signed areas of the triangles fanning
+  // from the plane origin to every segment
+  const std::vector<double> &crossings = this->Internals->IsoLine.Crossings;
+  const std::vector<vtkIdType> &segments = this->Internals->IsoLine.Segments;
+  double signedArea = 0.0;
+  for (std::size_t s=0; s<segments.size(); s+=2)
+    {
+    double start[3];
+    double end[3];
+    double cross[3];
+    vtkMath::Subtract(&crossings[3*segments[s]], origin, start);
+    vtkMath::Subtract(&crossings[3*segments[s+1]], origin, end);
+    vtkMath::Cross(start, end, cross);
+    signedArea += vtkMath::Dot(cross, normal)/2.0;
+    this->CutLength += std::sqrt(vtkMath::Distance2BetweenPoints(start, end));
+    }
+  this->CutArea = std::fabs(signedArea);
+
+  this->Internals->IsoLine.GetPolyLines(points, lines);
+
+  return 1;
+}
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program: NorMIT-Plan
+  Module: vtkPolyDataPlaneCutter.h
+
+  Copyright (c) 2017, The Intervention Centre, Oslo University Hospital
+
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+  may be used to endorse or promote products derived from this software
+  without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  =========================================================================*/
+
+#ifndef __vtkPolyDataPlaneCutter_h
+#define __vtkPolyDataPlaneCutter_h
+
+#include "vtkSlicerLiverMarkupsModuleMRMLExport.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+//-------------------------------------------------------------------------------
+class vtkPlane;
+class vtkPolyData;
+
+//------------------------------------------------------------------------------
+/**
+ * \ingroup ResectionPlanning
+ *
+ * \brief This class cuts a triangle mesh (e.g. the liver parenchyma) with a
+ * plane, producing the contour polylines together with the length of the
+ * contour and the area of the cut face.
+ *
+ * A bounding volume hierarchy over the triangles of the mesh is built once
+ * and reused for every plane, so moving the plane only visits the nodes
+ * whose box straddles it and the triangles they hold. Vertices lying on the
+ * plane count as being on its positive side, so every crossed triangle
+ * yields exactly one segment between two crossed edges. The crossings are
+ * keyed by the mesh edge they lie on, which joins the segments of
+ * neighbouring triangles without merging points by distance.
+ *
+ * Segments are oriented by the winding of their triangle, so on a closed,
+ * consistently oriented mesh they chain into closed polylines, and the
+ * contours of holes run opposite to the outer ones. The cut area is the
+ * absolute value of the sum of the signed areas of the polylines; it is
+ * only meaningful for closed meshes.
+ *
+ * The hierarchy is rebuilt when the mesh is modified, and the output is only
+ * recomputed when the mesh or the plane change.
+ */
+class VTK_SLICER_LIVERMARKUPS_MODULE_MRML_EXPORT vtkPolyDataPlaneCutter : public vtkPolyDataAlgorithm
+{
+ public:
+
+  /**
+   * Instantiation of object.
+   *
+   * @return pointer to vtkPolyDataPlaneCutter newly created.
+   */
+  static vtkPolyDataPlaneCutter *New();
+
+  vtkTypeMacro(vtkPolyDataPlaneCutter, vtkPolyDataAlgorithm);
+
+  /**
+   * Print the properties of the object.
+   *
+   * @param os ouptut stream to print the properties to.
+   * @param indent indentation value.
+   */
+  void PrintSelf(ostream &os, vtkIndent indent) override;
+
+  /**
+   * Set/get the mesh to cut. Polygons and triangle strips are used.
+   */
+  void SetMesh(vtkPolyData *mesh);
+  vtkPolyData *GetMesh() const;
+
+  /**
+   * Set/get the cutting plane.
+   */
+  void SetPlane(vtkPlane *plane);
+  vtkPlane *GetPlane() const;
+
+  /**
+   * Get the total length of the contour polylines.
+   */
+  vtkGetMacro(CutLength, double);
+
+  /**
+   * Get the area of the cut face, enclosed by the contour polylines.
+   */
+  vtkGetMacro(CutArea, double);
+
+  /**
+   * Get the number of triangles tested against the plane by the last cut.
+   */
+  vtkGetMacro(NumberOfVisitedTriangles, vtkIdType);
+
+  /**
+   * Get the modification time, including the one of the mesh and of the
+   * plane.
+   */
+  vtkMTimeType GetMTime() override;
+
+ protected:
+  vtkPolyDataPlaneCutter();
+  ~vtkPolyDataPlaneCutter() override;
+
+  /**
+   * Compute the contour polylines, their length and the cut area.
+   */
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+
+ private:
+  vtkPolyDataPlaneCutter(const vtkPolyDataPlaneCutter&);  // Not implemented.
+  void operator=(const vtkPolyDataPlaneCutter&);  // Not implemented.
+
+  class vtkInternals;
+  vtkInternals *Internals;
+
+  vtkSmartPointer<vtkPolyData> Mesh;
+  vtkSmartPointer<vtkPlane> Plane;
+
+  double CutLength;
+  double CutArea;
+  vtkIdType NumberOfVisitedTriangles;
+};
+
+#endif
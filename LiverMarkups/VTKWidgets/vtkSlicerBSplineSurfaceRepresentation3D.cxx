@@ -0,0 +1,310 @@
+/*==============================================================================
+
+ Distributed under the OSI-approved BSD 3-Clause License.
+
+  Copyright (c) Oslo University Hospital. All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+  * Neither the name of Oslo University Hospital nor the names
+    of Contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  This file was originally developed by Rafael Palomar (The Intervention Centre,
+  Oslo University Hospital) and was supported by The Research Council of Norway
+  through the ALive project (grant nr. 311393).
+
+  ==============================================================================*/
+
+#include "vtkSlicerBSplineSurfaceRepresentation3D.h"
+
+#include "vtkMRMLMarkupsBSplineSurfaceNode.h"
+
+// MRML includes
+#include <qMRMLThreeDWidget.h>
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLModelDisplayableManager.h>
+
+// Slicer includes
+#include <qSlicerApplication.h>
+#include <qSlicerLayoutManager.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkCellArray.h>
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerBSplineSurfaceRepresentation3D);
+
+//------------------------------------------------------------------------------
+vtkSlicerBSplineSurfaceRepresentation3D::vtkSlicerBSplineSurfaceRepresentation3D()
+  :Superclass()
+{
+  // The B-spline surface is evaluated by the markups node and shared by all
+  // the views; the mapper is connected to it in UpdateBSplineSurface.
+  this->BSplineSurfaceMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->BSplineSurfaceActor = vtkSmartPointer<vtkActor>::New();
+  this->BSplineSurfaceActor->SetMapper(this->BSplineSurfaceMapper);
+
+  this->ControlPolygonPolyData = vtkSmartPointer<vtkPolyData>::New();
+  this->ControlPolygonTubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
+  this->ControlPolygonTubeFilter->SetInputData(this->ControlPolygonPolyData.GetPointer());
+  this->ControlPolygonTubeFilter->SetRadius(1);
+  this->ControlPolygonTubeFilter->SetNumberOfSides(20);
+
+  this->ControlPolygonMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->ControlPolygonMapper->SetInputConnection(this->ControlPolygonTubeFilter->GetOutputPort());
+
+  this->ControlPolygonActor = vtkSmartPointer<vtkActor>::New();
+  this->ControlPolygonActor->SetMapper(this->ControlPolygonMapper);
+  this->ControlPolygonNetSize[0] = 0;
+  this->ControlPolygonNetSize[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerBSplineSurfaceRepresentation3D::~vtkSlicerBSplineSurfaceRepresentation3D() = default;
+
+//----------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData /*=nullptr*/)
+{
+
+ this->Superclass::UpdateFromMRML(caller, event, callData);
+
+ auto liverMarkupsBSplineSurfaceNode =
+   vtkMRMLMarkupsBSplineSurfaceNode::SafeDownCast(this->GetMarkupsNode());
+ if (!liverMarkupsBSplineSurfaceNode || !this->IsDisplayable())
+   {
+   this->VisibilityOff();
+   return;
+   }
+
+ this->UpdateBSplineSurface(liverMarkupsBSplineSurfaceNode);
+ this->UpdateControlPolygon(liverMarkupsBSplineSurfaceNode);
+
+  double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
+    this->MarkupsDisplayNode->GetLineDiameter() : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
+  this->ControlPolygonTubeFilter->SetRadius(diameter * 0.5);
+
+  int controlPointType = Active;
+  if (this->MarkupsDisplayNode->GetActiveComponentType() != vtkMRMLMarkupsDisplayNode::ComponentLine)
+    {
+    controlPointType = this->GetAllControlPointsSelected() ? Selected : Unselected;
+    }
+  this->ControlPolygonActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+
+ this->NeedToRenderOn();
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::GetActors(vtkPropCollection *pc)
+{
+  this->Superclass::GetActors(pc);
+  this->BSplineSurfaceActor->GetActors(pc);
+  this->ControlPolygonActor->GetActors(pc);
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::ReleaseGraphicsResources(
+  vtkWindow *win)
+{
+  this->Superclass::ReleaseGraphicsResources(win);
+  this->BSplineSurfaceActor->ReleaseGraphicsResources(win);
+  this->ControlPolygonActor->ReleaseGraphicsResources(win);
+}
+
+//----------------------------------------------------------------------
+int vtkSlicerBSplineSurfaceRepresentation3D::RenderOverlay(vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderOverlay(viewport);
+  if (this->BSplineSurfaceActor->GetVisibility())
+    {
+    count +=  this->BSplineSurfaceActor->RenderOverlay(viewport);
+    count +=  this->ControlPolygonActor->RenderOverlay(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerBSplineSurfaceRepresentation3D::RenderOpaqueGeometry(
+  vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderOpaqueGeometry(viewport);
+  if (this->BSplineSurfaceActor->GetVisibility())
+    {
+    count += this->BSplineSurfaceActor->RenderOpaqueGeometry(viewport);
+    }
+  if (this->ControlPolygonActor->GetVisibility())
+    {
+    double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
+                        this->MarkupsDisplayNode->GetLineDiameter() : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
+    this->ControlPolygonTubeFilter->SetRadius(diameter * 0.5);
+    count += this->ControlPolygonActor->RenderOpaqueGeometry(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerBSplineSurfaceRepresentation3D::RenderTranslucentPolygonalGeometry(
+  vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderTranslucentPolygonalGeometry(viewport);
+  if (this->BSplineSurfaceActor->GetVisibility())
+    {
+    // The internal actor needs to share property keys.
+    // This ensures the mapper state is consistent and allows depth peeling to work as expected.
+    this->BSplineSurfaceActor->SetPropertyKeys(this->GetPropertyKeys());
+    count += this->BSplineSurfaceActor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  if (this->ControlPolygonActor->GetVisibility())
+    {
+    // The internal actor needs to share property keys.
+    // This ensures the mapper state is consistent and allows depth peeling to work as expected.
+    this->ControlPolygonActor->SetPropertyKeys(this->GetPropertyKeys());
+    count += this->ControlPolygonActor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeBool vtkSlicerBSplineSurfaceRepresentation3D::HasTranslucentPolygonalGeometry()
+{
+  if (this->Superclass::HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  if (this->BSplineSurfaceActor->GetVisibility() && this->BSplineSurfaceActor->HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  if (this->ControlPolygonActor->GetVisibility() && this->ControlPolygonActor->HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------
+double *vtkSlicerBSplineSurfaceRepresentation3D::GetBounds()
+{
+  vtkBoundingBox boundingBox;
+  const std::vector<vtkProp*> actors({ this->BSplineSurfaceActor, this->ControlPolygonActor });
+  this->AddActorsBounds(boundingBox, actors, Superclass::GetBounds());
+  boundingBox.GetBounds(this->Bounds);
+  return this->Bounds;
+}
+
+
+//-----------------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::PrintSelf(ostream& os, vtkIndent indent)
+{
+  //Superclass typedef defined in vtkTypeMacro() found in vtkSetGet.h
+  this->Superclass::PrintSelf(os, indent);
+
+  if (this->BSplineSurfaceActor)
+    {
+    os << indent << "BSplineSurface Visibility: " << this->BSplineSurfaceActor->GetVisibility() << "\n";
+    }
+  else
+    {
+    os << indent << "BSplineSurface Visibility: (none)\n";
+    }
+
+  if (this->ControlPolygonActor)
+    {
+    os << indent << "ControlPolygon Visibility: " << this->ControlPolygonActor->GetVisibility() << "\n";
+    }
+  else
+    {
+    os << indent << "ControlPolygon Visibility: (none)\n";
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::UpdateBSplineSurface(vtkMRMLMarkupsBSplineSurfaceNode *node)
+{
+  if (!node)
+    {
+    return;
+    }
+
+  // Only the first view to update after a change of the control points
+  // triggers the evaluation of the surface, and only of the knot spans the
+  // moved control points influence
+  node->UpdateBSplineSurfaceControlPoints();
+
+  vtkAlgorithmOutput* bsplineSurfaceOutputPort = node->GetBSplineSurfaceOutputPort();
+  if (this->BSplineSurfaceMapper->GetInputConnection(0, 0) != bsplineSurfaceOutputPort)
+    {
+    this->BSplineSurfaceMapper->SetInputConnection(bsplineSurfaceOutputPort);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerBSplineSurfaceRepresentation3D::UpdateControlPolygon(vtkMRMLMarkupsBSplineSurfaceNode *node)
+{
+  int netSize[2];
+  node->GetControlNetSize(netSize);
+  if (node->GetNumberOfControlPoints() != netSize[0]*netSize[1])
+    {
+    return;
+    }
+
+  // The control net is drawn as one polyline per row and column; its
+  // topology only changes with the size of the net
+  if (netSize[0] != this->ControlPolygonNetSize[0] ||
+      netSize[1] != this->ControlPolygonNetSize[1])
+    {
+    vtkNew<vtkCellArray> netLines;
+    for (int i=0; i<netSize[0]; i++)
+      {
+      netLines->InsertNextCell(netSize[1]);
+      for (int j=0; j<netSize[1]; j++)
+        {
+        netLines->InsertCellPoint(i*netSize[1]+j);
+        }
+      }
+    for (int j=0; j<netSize[1]; j++)
+      {
+      netLines->InsertNextCell(netSize[0]);
+      for (int i=0; i<netSize[0]; i++)
+        {
+        netLines->InsertCellPoint(i*netSize[1]+j);
+        }
+      }
+
+    this->ControlPolygonPolyData->SetLines(netLines);
+    this->ControlPolygonNetSize[0] = netSize[0];
+    this->ControlPolygonNetSize[1] = netSize[1];
+    }
+
+  this->ControlPolygonPolyData->SetPoints(node->GetBSplineSurfaceControlPoints());
+}
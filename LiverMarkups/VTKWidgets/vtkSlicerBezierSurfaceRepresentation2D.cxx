@@ -39,20 +39,191 @@
 
 #include "vtkSlicerBezierSurfaceRepresentation2D.h"
 
+// Liver Markups MRML includes
+#include "vtkBezierSurfacePlaneCutter.h"
+#include "vtkMRMLMarkupsBezierSurfaceNode.h"
+
+// VTK includes
+#include <vtkActor2D.h>
+#include <vtkPlane.h>
+#include <vtkPolyDataMapper2D.h>
+#include <vtkProperty2D.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkTubeFilter.h>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerBezierSurfaceRepresentation2D);
 
 //------------------------------------------------------------------------------
 vtkSlicerBezierSurfaceRepresentation2D::vtkSlicerBezierSurfaceRepresentation2D()
+  :Superclass()
 {
+  // The intersection is computed in world coordinates on the exact surface
+  // shared by the node, and only then transformed to the slice.
+  this->SliceIntersectionPlane = vtkSmartPointer<vtkPlane>::New();
+  this->SliceIntersectionCutter = vtkSmartPointer<vtkBezierSurfacePlaneCutter>::New();
+  this->SliceIntersectionCutter->SetPlane(this->SliceIntersectionPlane);
+
+  this->SliceIntersectionWorldToSliceTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  this->SliceIntersectionWorldToSliceTransformer->SetTransform(this->WorldToSliceTransform);
+  this->SliceIntersectionWorldToSliceTransformer->SetInputConnection(this->SliceIntersectionCutter->GetOutputPort());
+
+  this->SliceIntersectionTubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
+  this->SliceIntersectionTubeFilter->SetInputConnection(this->SliceIntersectionWorldToSliceTransformer->GetOutputPort());
+  this->SliceIntersectionTubeFilter->SetNumberOfSides(6);
+  this->SliceIntersectionTubeFilter->SetRadius(1);
+
+  this->SliceIntersectionMapper = vtkSmartPointer<vtkPolyDataMapper2D>::New();
+  this->SliceIntersectionMapper->SetInputConnection(this->SliceIntersectionTubeFilter->GetOutputPort());
 
+  this->SliceIntersectionActor = vtkSmartPointer<vtkActor2D>::New();
+  this->SliceIntersectionActor->SetMapper(this->SliceIntersectionMapper);
 }
 
 //------------------------------------------------------------------------------
 vtkSlicerBezierSurfaceRepresentation2D::~vtkSlicerBezierSurfaceRepresentation2D() = default;
 
-//------------------------------------------------------------------------------
+//----------------------------------------------------------------------
+void vtkSlicerBezierSurfaceRepresentation2D::UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void *callData /*=nullptr*/)
+{
+  // The superclass updates the slice plane and the world to slice transform
+  this->Superclass::UpdateFromMRML(caller, event, callData);
+
+  auto liverMarkupsBezierSurfaceNode =
+    vtkMRMLMarkupsBezierSurfaceNode::SafeDownCast(this->GetMarkupsNode());
+  if (!liverMarkupsBezierSurfaceNode || !this->IsDisplayable())
+    {
+    this->VisibilityOff();
+    return;
+    }
+
+  this->VisibilityOn();
+
+  this->UpdateSliceIntersection(liverMarkupsBezierSurfaceNode);
+
+  double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
+    this->MarkupsDisplayNode->GetLineDiameter() / this->ScaleFactor2D : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
+  this->SliceIntersectionTubeFilter->SetRadius(diameter * 0.5);
+
+  int controlPointType = Active;
+  if (this->MarkupsDisplayNode->GetActiveComponentType() != vtkMRMLMarkupsDisplayNode::ComponentLine)
+    {
+    controlPointType = this->GetAllControlPointsSelected() ? Selected : Unselected;
+    }
+  this->SliceIntersectionActor->SetProperty(this->GetControlPointsPipeline(controlPointType)->Property);
+
+  this->NeedToRenderOn();
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerBezierSurfaceRepresentation2D::GetActors(vtkPropCollection *pc)
+{
+  this->Superclass::GetActors(pc);
+  this->SliceIntersectionActor->GetActors(pc);
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerBezierSurfaceRepresentation2D::ReleaseGraphicsResources(
+  vtkWindow *win)
+{
+  this->Superclass::ReleaseGraphicsResources(win);
+  this->SliceIntersectionActor->ReleaseGraphicsResources(win);
+}
+
+//----------------------------------------------------------------------
+int vtkSlicerBezierSurfaceRepresentation2D::RenderOverlay(vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderOverlay(viewport);
+  if (this->SliceIntersectionActor->GetVisibility())
+    {
+    count += this->SliceIntersectionActor->RenderOverlay(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerBezierSurfaceRepresentation2D::RenderOpaqueGeometry(
+  vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderOpaqueGeometry(viewport);
+  if (this->SliceIntersectionActor->GetVisibility())
+    {
+    count += this->SliceIntersectionActor->RenderOpaqueGeometry(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSlicerBezierSurfaceRepresentation2D::RenderTranslucentPolygonalGeometry(
+  vtkViewport *viewport)
+{
+  int count=0;
+  count = this->Superclass::RenderTranslucentPolygonalGeometry(viewport);
+  if (this->SliceIntersectionActor->GetVisibility())
+    {
+    // The internal actor needs to share property keys.
+    // This ensures the mapper state is consistent and allows depth peeling to work as expected.
+    this->SliceIntersectionActor->SetPropertyKeys(this->GetPropertyKeys());
+    count += this->SliceIntersectionActor->RenderTranslucentPolygonalGeometry(viewport);
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeBool vtkSlicerBezierSurfaceRepresentation2D::HasTranslucentPolygonalGeometry()
+{
+  if (this->Superclass::HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  if (this->SliceIntersectionActor->GetVisibility() && this->SliceIntersectionActor->HasTranslucentPolygonalGeometry())
+    {
+    return true;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
 void vtkSlicerBezierSurfaceRepresentation2D::PrintSelf(ostream& os, vtkIndent indent)
 {
-  Superclass::PrintSelf(os, indent);
+  //Superclass typedef defined in vtkTypeMacro() found in vtkSetGet.h
+  this->Superclass::PrintSelf(os, indent);
+
+  if (this->SliceIntersectionActor)
+    {
+    os << indent << "SliceIntersection Visibility: " << this->SliceIntersectionActor->GetVisibility() << "\n";
+    }
+  else
+    {
+    os << indent << "SliceIntersection Visibility: (none)\n";
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerBezierSurfaceRepresentation2D::UpdateSliceIntersection(vtkMRMLMarkupsBezierSurfaceNode *node)
+{
+  if (!node || node->GetNumberOfControlPoints() != 16)
+    {
+    this->SliceIntersectionActor->SetVisibility(false);
+    return;
+    }
+
+  // Only the first view to update after a change of the control points
+  // marks the surface as modified. The cutter then runs again when the slice
+  // is rendered, if the control points or the slice plane changed since the
+  // last intersection.
+  node->UpdateBezierSurfaceControlPoints();
+  this->SliceIntersectionCutter->SetSurface(node->GetBezierSurfaceSource());
+
+  // The cutting plane is only modified when the slice actually moved
+  double origin[3];
+  double normal[3];
+  this->SlicePlane->GetOrigin(origin);
+  this->SlicePlane->GetNormal(normal);
+  this->SliceIntersectionPlane->SetOrigin(origin);
+  this->SliceIntersectionPlane->SetNormal(normal);
+  this->SliceIntersectionActor->SetVisibility(true);
 }
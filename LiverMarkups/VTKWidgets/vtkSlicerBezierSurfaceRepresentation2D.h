@@ -36,29 +36,68 @@
   through the ALive project (grant nr. 311393).
 
 ==============================================================================*/
-#ifndef __vtkslicerbeziersurfacewidgetrepresentation3d_h_
-#define __vtkslicerbeziersurfacewidgetrepresentation3d_h_
+#ifndef __vtkslicerbeziersurfacewidgetrepresentation2d_h_
+#define __vtkslicerbeziersurfacewidgetrepresentation2d_h_
 
 #include "vtkSlicerLiverMarkupsModuleVTKWidgetsExport.h"
 
 // Markups VTKWidgets includes
-#include "vtkSlicerLineRepresentation2D.h"
+#include "vtkSlicerMarkupsWidgetRepresentation2D.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
+//------------------------------------------------------------------------------
+class vtkActor2D;
+class vtkBezierSurfacePlaneCutter;
+class vtkPlane;
+class vtkPolyDataMapper2D;
+class vtkTransformPolyDataFilter;
+class vtkTubeFilter;
+class vtkMRMLMarkupsBezierSurfaceNode;
+
+//------------------------------------------------------------------------------
+/// \brief Slice view representation of the Bezier surface markup.
+///
+/// The intersection of the exact Bezier surface with the slice plane is drawn
+/// as a set of polylines (see vtkBezierSurfacePlaneCutter). The intersection
+/// is only recomputed when the slice or the control points change.
 class VTK_SLICER_LIVERMARKUPS_MODULE_VTKWIDGETS_EXPORT vtkSlicerBezierSurfaceRepresentation2D
-: public vtkSlicerLineRepresentation2D
+: public vtkSlicerMarkupsWidgetRepresentation2D
 {
 public:
   static vtkSlicerBezierSurfaceRepresentation2D* New();
-  vtkTypeMacro(vtkSlicerBezierSurfaceRepresentation2D, vtkSlicerLineRepresentation2D);
+  vtkTypeMacro(vtkSlicerBezierSurfaceRepresentation2D, vtkSlicerMarkupsWidgetRepresentation2D);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  void UpdateFromMRML(vtkMRMLNode* caller, unsigned long event, void* callData=nullptr) override;
+
+  /// Methods to make this class behave as a vtkProp.
+  void GetActors(vtkPropCollection *) override;
+  void ReleaseGraphicsResources(vtkWindow *) override;
+  int RenderOverlay(vtkViewport *viewport) override;
+  int RenderOpaqueGeometry(vtkViewport *viewport) override;
+  int RenderTranslucentPolygonalGeometry(vtkViewport *viewport) override;
+  vtkTypeBool HasTranslucentPolygonalGeometry() override;
+
+protected:
+  // Intersection of the Bezier surface with the slice plane
+  vtkSmartPointer<vtkPlane> SliceIntersectionPlane;
+  vtkSmartPointer<vtkBezierSurfacePlaneCutter> SliceIntersectionCutter;
+  vtkSmartPointer<vtkTransformPolyDataFilter> SliceIntersectionWorldToSliceTransformer;
+  vtkSmartPointer<vtkTubeFilter> SliceIntersectionTubeFilter;
+  vtkSmartPointer<vtkPolyDataMapper2D> SliceIntersectionMapper;
+  vtkSmartPointer<vtkActor2D> SliceIntersectionActor;
+
 protected:
   vtkSlicerBezierSurfaceRepresentation2D();
   ~vtkSlicerBezierSurfaceRepresentation2D() override;
 
+  void UpdateSliceIntersection(vtkMRMLMarkupsBezierSurfaceNode*);
+
 private:
   vtkSlicerBezierSurfaceRepresentation2D(const vtkSlicerBezierSurfaceRepresentation2D&) = delete;
   void operator=(const vtkSlicerBezierSurfaceRepresentation2D&) = delete;
 };
 
-#endif // __vtkslicerbeziersurfacewidgetrepresentation3d_h_
+#endif // __vtkslicerbeziersurfacewidgetrepresentation2d_h_
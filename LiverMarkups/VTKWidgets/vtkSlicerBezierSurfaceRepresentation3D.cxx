@@ -39,8 +39,8 @@
 
 #include "vtkSlicerBezierSurfaceRepresentation3D.h"
 
-#include "vtkMRMLMarkupsBezierSurfaceNode.h"
 #include "vtkBezierSurfaceSource.h"
+#include "vtkMRMLMarkupsBezierSurfaceNode.h"
 
 // MRML includes
 #include <qMRMLThreeDWidget.h>
@@ -53,13 +53,50 @@
 
 // VTK includes
 #include <vtkActor.h>
+#include <vtkAlgorithmOutput.h>
 #include <vtkCollection.h>
+#include <vtkCylinderSource.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
-#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
-#include <vtkPolyDataNormals.h>
-#include <vtkPolyLine.h>
 #include <vtkProperty.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Edges of the 4x4 control net: 12 along each parametric direction
+const int BezierSurfaceControlNetSize = 4;
+const int BezierSurfaceControlPolygonNumberOfEdges =
+  2*BezierSurfaceControlNetSize*(BezierSurfaceControlNetSize-1);
+
+//------------------------------------------------------------------------------
+void GetBezierSurfaceControlPolygonEdge(int edge, vtkIdType &first, vtkIdType &second)
+{
+  const int n = BezierSurfaceControlNetSize;
+  int edgesPerDirection = n*(n-1);
+  int i = (edge % edgesPerDirection) / (n-1);
+  int j = (edge % edgesPerDirection) % (n-1);
+  if (edge < edgesPerDirection)
+    {
+    // Along v, in row i
+    first = i*n + j;
+    second = i*n + j + 1;
+    }
+  else
+    {
+    // Along u, in column i
+    first = j*n + i;
+    second = (j+1)*n + i;
+    }
+}
+}
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerBezierSurfaceRepresentation3D);
@@ -68,33 +105,59 @@ vtkStandardNewMacro(vtkSlicerBezierSurfaceRepresentation3D);
 vtkSlicerBezierSurfaceRepresentation3D::vtkSlicerBezierSurfaceRepresentation3D()
   :Superclass()
 {
-  this->BezierSurfaceSource= vtkSmartPointer<vtkBezierSurfaceSource>::New();
-
-  // Set the initial position of the bezier surface
-  auto planeSource = vtkSmartPointer<vtkPlaneSource>::New();
-  planeSource->SetResolution(3,3);
-  planeSource->Update();
-
-  this->BezierSurfaceNormals = vtkSmartPointer<vtkPolyDataNormals>::New();
-  this->BezierSurfaceNormals->SetInputConnection(this->BezierSurfaceSource->GetOutputPort());
-
-  this->BezierSurfaceControlPoints = vtkSmartPointer<vtkPoints>::New();
-  this->BezierSurfaceControlPoints->SetNumberOfPoints(16);
-  this->BezierSurfaceControlPoints->DeepCopy(planeSource->GetOutput()->GetPoints());;
-
+  // The Bezier surface is evaluated by the markups node and shared by all
+  // the views; the mapper is connected to it in UpdateBezierSurface.
   this->BezierSurfaceMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  this->BezierSurfaceMapper->SetInputConnection(this->BezierSurfaceNormals->GetOutputPort());
   this->BezierSurfaceActor = vtkSmartPointer<vtkActor>::New();
   this->BezierSurfaceActor->SetMapper(this->BezierSurfaceMapper);
 
+  // The control polygon is a fixed set of edges, so its arrays are allocated
+  // once and only their values change when control points are moved
+  vtkNew<vtkPoints> edgeCenters;
+  edgeCenters->SetDataTypeToDouble();
+  edgeCenters->SetNumberOfPoints(BezierSurfaceControlPolygonNumberOfEdges);
+  this->ControlPolygonEdgeDirections = vtkSmartPointer<vtkDoubleArray>::New();
+  this->ControlPolygonEdgeDirections->SetName("EdgeDirections");
+  this->ControlPolygonEdgeDirections->SetNumberOfComponents(3);
+  this->ControlPolygonEdgeDirections->SetNumberOfTuples(BezierSurfaceControlPolygonNumberOfEdges);
+  this->ControlPolygonEdgeScales = vtkSmartPointer<vtkDoubleArray>::New();
+  this->ControlPolygonEdgeScales->SetName("EdgeScales");
+  this->ControlPolygonEdgeScales->SetNumberOfComponents(3);
+  this->ControlPolygonEdgeScales->SetNumberOfTuples(BezierSurfaceControlPolygonNumberOfEdges);
+  for (int e=0; e<BezierSurfaceControlPolygonNumberOfEdges; e++)
+    {
+    edgeCenters->SetPoint(e, 0.0, 0.0, 0.0);
+    this->ControlPolygonEdgeDirections->SetTuple3(e, 1.0, 0.0, 0.0);
+    this->ControlPolygonEdgeScales->SetTuple3(e, 0.0, 0.0, 0.0);
+    }
   this->ControlPolygonPolyData = vtkSmartPointer<vtkPolyData>::New();
-  this->ControlPolygonTubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
-  this->ControlPolygonTubeFilter->SetInputData(this->ControlPolygonPolyData.GetPointer());
-  this->ControlPolygonTubeFilter->SetRadius(1);
-  this->ControlPolygonTubeFilter->SetNumberOfSides(20);
-
-  this->ControlPolygonMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  this->ControlPolygonMapper->SetInputConnection(this->ControlPolygonTubeFilter->GetOutputPort());
+  this->ControlPolygonPolyData->SetPoints(edgeCenters);
+  this->ControlPolygonPolyData->GetPointData()->AddArray(this->ControlPolygonEdgeDirections);
+  this->ControlPolygonPolyData->GetPointData()->AddArray(this->ControlPolygonEdgeScales);
+  this->ControlPolygonPointsTime = 0;
+  this->ControlPolygonDiameter = 0.0;
+
+  // Open cylinder of unit length and diameter along the x axis, which the
+  // glyph mapper orients along the edges
+  vtkNew<vtkCylinderSource> cylinderSource;
+  cylinderSource->SetHeight(1.0);
+  cylinderSource->SetRadius(0.5);
+  cylinderSource->SetResolution(12);
+  cylinderSource->CappingOff();
+  vtkNew<vtkTransform> cylinderToEdge;
+  cylinderToEdge->RotateZ(-90.0);
+  vtkNew<vtkTransformPolyDataFilter> cylinder;
+  cylinder->SetTransform(cylinderToEdge);
+  cylinder->SetInputConnection(cylinderSource->GetOutputPort());
+
+  this->ControlPolygonMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+  this->ControlPolygonMapper->SetInputData(this->ControlPolygonPolyData);
+  this->ControlPolygonMapper->SetSourceConnection(cylinder->GetOutputPort());
+  this->ControlPolygonMapper->SetOrientationArray("EdgeDirections");
+  this->ControlPolygonMapper->SetOrientationModeToDirection();
+  this->ControlPolygonMapper->SetScaleArray("EdgeScales");
+  this->ControlPolygonMapper->SetScaleModeToScaleByVectorComponents();
+  this->ControlPolygonMapper->ScalingOn();
 
   this->ControlPolygonActor = vtkSmartPointer<vtkActor>::New();
   this->ControlPolygonActor->SetMapper(this->ControlPolygonMapper);
@@ -119,10 +182,7 @@ void vtkSlicerBezierSurfaceRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
 
  this->UpdateBezierSurface(liverMarkupsBezierSurfaceNode);
  this->UpdateControlPolygon(liverMarkupsBezierSurfaceNode);
-
-  double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
-    this->MarkupsDisplayNode->GetLineDiameter() : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
-  this->ControlPolygonTubeFilter->SetRadius(diameter * 0.5);
+ this->UpdateControlPolygonDiameter();
 
   int controlPointType = Active;
   if (this->MarkupsDisplayNode->GetActiveComponentType() != vtkMRMLMarkupsDisplayNode::ComponentLine)
@@ -176,9 +236,7 @@ int vtkSlicerBezierSurfaceRepresentation3D::RenderOpaqueGeometry(
     }
   if (this->ControlPolygonActor->GetVisibility())
     {
-    double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
-                        this->MarkupsDisplayNode->GetLineDiameter() : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
-    this->ControlPolygonTubeFilter->SetRadius(diameter * 0.5);
+    this->UpdateControlPolygonDiameter();
     count += this->ControlPolygonActor->RenderOpaqueGeometry(viewport);
     }
   return count;
@@ -303,46 +361,81 @@ void vtkSlicerBezierSurfaceRepresentation3D::UpdateBezierSurface(vtkMRMLMarkupsB
     return;
     }
 
-  if (node->GetNumberOfControlPoints() == 16)
+  // Only the first view to update after a change of the control points
+  // triggers the evaluation of the surface
+  node->UpdateBezierSurfaceControlPoints();
+
+  // Immediate feedback when the surface passes through a tumor. Once the
+  // query of a change completed, the other views read the cached result; a
+  // query cut by the time budget is resumed by the next view to update.
+  if (node->UpdateTumorCollision())
+    {
+    this->BezierSurfaceActor->GetProperty()->SetColor(1.0, 0.0, 0.0);
+    }
+  else
+    {
+    this->BezierSurfaceActor->GetProperty()->SetColor(1.0, 1.0, 1.0);
+    }
+
+  vtkAlgorithmOutput* bezierSurfaceOutputPort = node->GetBezierSurfaceOutputPort();
+  if (this->BezierSurfaceMapper->GetInputConnection(0, 0) != bezierSurfaceOutputPort)
     {
-    for (int i=0; i<16; i++)
-      {
-      double point[3];
-      node->GetNthControlPointPosition(i,point);
-      this->BezierSurfaceControlPoints->SetPoint(i,
-                                                 static_cast<float>(point[0]),
-                                                 static_cast<float>(point[1]),
-                                                 static_cast<float>(point[2]));
-      }
-
-    this->BezierSurfaceSource->SetControlPoints(this->BezierSurfaceControlPoints);
+    this->BezierSurfaceMapper->SetInputConnection(bezierSurfaceOutputPort);
     }
 }
 
 //-----------------------------------------------------------------------------
 void vtkSlicerBezierSurfaceRepresentation3D::UpdateControlPolygon(vtkMRMLMarkupsBezierSurfaceNode *node)
 {
-  if (node->GetNumberOfControlPoints() == 16)
+  if (node->GetNumberOfControlPoints() != 16)
+    {
+    this->ControlPolygonActor->SetVisibility(false);
+    return;
+    }
+  this->ControlPolygonActor->SetVisibility(true);
+
+  // The surface source is modified whenever a control point moves
+  vtkMTimeType controlPointsTime = node->GetBezierSurfaceSource()->GetMTime();
+  if (controlPointsTime == this->ControlPolygonPointsTime)
+    {
+    return;
+    }
+  this->ControlPolygonPointsTime = controlPointsTime;
+
+  vtkPoints* controlPoints = node->GetBezierSurfaceControlPoints();
+  vtkPoints* edgeCenters = this->ControlPolygonPolyData->GetPoints();
+  for (int e=0; e<BezierSurfaceControlPolygonNumberOfEdges; e++)
+    {
+    vtkIdType first, second;
+    GetBezierSurfaceControlPolygonEdge(e, first, second);
+    double p[3], q[3];
+    controlPoints->GetPoint(first, p);
+    controlPoints->GetPoint(second, q);
+    double direction[3] = {q[0]-p[0], q[1]-p[1], q[2]-p[2]};
+    edgeCenters->SetPoint(e, 0.5*(p[0]+q[0]), 0.5*(p[1]+q[1]), 0.5*(p[2]+q[2]));
+    this->ControlPolygonEdgeDirections->SetTuple(e, direction);
+    this->ControlPolygonEdgeScales->SetComponent(e, 0, vtkMath::Norm(direction));
+    }
+  edgeCenters->Modified();
+  this->ControlPolygonEdgeDirections->Modified();
+  this->ControlPolygonEdgeScales->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerBezierSurfaceRepresentation3D::UpdateControlPolygonDiameter()
+{
+  double diameter = ( this->MarkupsDisplayNode->GetCurveLineSizeMode() == vtkMRMLMarkupsDisplayNode::UseLineDiameter ?
+                      this->MarkupsDisplayNode->GetLineDiameter() : this->ControlPointSize * this->MarkupsDisplayNode->GetLineThickness() );
+  if (diameter == this->ControlPolygonDiameter)
+    {
+    return;
+    }
+  this->ControlPolygonDiameter = diameter;
+
+  for (int e=0; e<BezierSurfaceControlPolygonNumberOfEdges; e++)
     {
-    //Generate topology;
-    vtkSmartPointer<vtkCellArray> planeCells =
-      vtkSmartPointer<vtkCellArray>::New();
-    for(int i=0; i<3; ++i)
-      {
-      for(int j=0; j<3; ++j)
-        {
-        vtkSmartPointer<vtkPolyLine> polyLine = vtkSmartPointer<vtkPolyLine>::New();
-        polyLine->GetPointIds()->SetNumberOfIds(5);
-        polyLine->GetPointIds()->SetId(0,i*4+j);
-        polyLine->GetPointIds()->SetId(1,i*4+j+1);
-        polyLine->GetPointIds()->SetId(2,(i+1)*4+j+1);
-        polyLine->GetPointIds()->SetId(3,(i+1)*4+j);
-        polyLine->GetPointIds()->SetId(4,i*4+j);
-        planeCells->InsertNextCell(polyLine);
-        }
-      }
-
-    this->ControlPolygonPolyData->SetPoints(this->BezierSurfaceControlPoints);
-    this->ControlPolygonPolyData->SetLines(planeCells);
+    this->ControlPolygonEdgeScales->SetComponent(e, 1, diameter);
+    this->ControlPolygonEdgeScales->SetComponent(e, 2, diameter);
     }
+  this->ControlPolygonEdgeScales->Modified();
 }
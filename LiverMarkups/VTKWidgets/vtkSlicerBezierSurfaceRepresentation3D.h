@@ -53,11 +53,10 @@
 #include <vtkSmartPointer.h>
 
 //------------------------------------------------------------------------------
-class vtkBezierSurfaceSource;
+class vtkDoubleArray;
+class vtkGlyph3DMapper;
 class vtkPolyData;
-class vtkPolyDataNormals;
 class vtkPoints;
-class vtkTubeFilter;
 class vtkMRMLMarkupsBezierSurfaceNode;
 
 //------------------------------------------------------------------------------
@@ -84,23 +83,26 @@ public:
 
 protected:
   // Bezier surface releated elements
-  vtkSmartPointer<vtkBezierSurfaceSource> BezierSurfaceSource;
-  vtkSmartPointer<vtkPoints> BezierSurfaceControlPoints;
   vtkSmartPointer<vtkPolyDataMapper> BezierSurfaceMapper;
   vtkSmartPointer<vtkActor> BezierSurfaceActor;
-  vtkSmartPointer<vtkPolyDataNormals> BezierSurfaceNormals;
 
-  // Control polygon related elements
+  // Control polygon related elements. Each edge of the control net is an
+  // instance of the same cylinder, placed at the center of the edge and
+  // scaled to its length and to the line diameter.
   vtkSmartPointer<vtkPolyData> ControlPolygonPolyData;
-  vtkSmartPointer<vtkTubeFilter> ControlPolygonTubeFilter;
-  vtkSmartPointer<vtkPolyDataMapper> ControlPolygonMapper;
+  vtkSmartPointer<vtkDoubleArray> ControlPolygonEdgeDirections;
+  vtkSmartPointer<vtkDoubleArray> ControlPolygonEdgeScales;
+  vtkSmartPointer<vtkGlyph3DMapper> ControlPolygonMapper;
   vtkSmartPointer<vtkActor> ControlPolygonActor;
+  vtkMTimeType ControlPolygonPointsTime;
+  double ControlPolygonDiameter;
 
 protected:
   vtkSlicerBezierSurfaceRepresentation3D();
   ~vtkSlicerBezierSurfaceRepresentation3D() override;
 
   void UpdateControlPolygon(vtkMRMLMarkupsBezierSurfaceNode*);
+  void UpdateControlPolygonDiameter();
   void UpdateBezierSurface(vtkMRMLMarkupsBezierSurfaceNode*);
 
 private:
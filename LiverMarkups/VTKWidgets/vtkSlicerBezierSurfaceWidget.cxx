@@ -40,14 +40,15 @@
 #include "vtkSlicerBezierSurfaceWidget.h"
 
 // Liver Markups VTKWidgets include
+#include "vtkSlicerBezierSurfaceRepresentation2D.h"
 #include "vtkSlicerBezierSurfaceRepresentation3D.h"
 
+// Liver Markups MRML includes
+#include "vtkMRMLMarkupsBezierSurfaceNode.h"
+
 // VTK includes
 #include <vtkObjectFactory.h>
 
-// Markups VTKWidgets includes
-#include <vtkSlicerLineRepresentation2D.h>
-
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerBezierSurfaceWidget);
 
@@ -68,7 +69,7 @@ void vtkSlicerBezierSurfaceWidget::CreateDefaultRepresentation(vtkMRMLMarkupsDis
   vtkSmartPointer<vtkSlicerMarkupsWidgetRepresentation> rep = nullptr;
   if (vtkMRMLSliceNode::SafeDownCast(viewNode))
     {
-    rep = vtkSmartPointer<vtkSlicerLineRepresentation2D>::New();
+    rep = vtkSmartPointer<vtkSlicerBezierSurfaceRepresentation2D>::New();
     }
   else
     {
@@ -81,6 +82,30 @@ void vtkSlicerBezierSurfaceWidget::CreateDefaultRepresentation(vtkMRMLMarkupsDis
   rep->UpdateFromMRML(nullptr, 0); // full update
 }
 
+//------------------------------------------------------------------------------
+void vtkSlicerBezierSurfaceWidget::StartWidgetInteraction(vtkEventData* startEventData)
+{
+  this->Superclass::StartWidgetInteraction(startEventData);
+
+  auto bezierSurfaceNode = vtkMRMLMarkupsBezierSurfaceNode::SafeDownCast(this->GetMarkupsNode());
+  if (bezierSurfaceNode)
+    {
+    bezierSurfaceNode->SetInteractionActive(true);
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerBezierSurfaceWidget::EndWidgetInteraction()
+{
+  this->Superclass::EndWidgetInteraction();
+
+  auto bezierSurfaceNode = vtkMRMLMarkupsBezierSurfaceNode::SafeDownCast(this->GetMarkupsNode());
+  if (bezierSurfaceNode)
+    {
+    bezierSurfaceNode->SetInteractionActive(false);
+    }
+}
+
 //------------------------------------------------------------------------------
 vtkSlicerMarkupsWidget* vtkSlicerBezierSurfaceWidget::CreateInstance() const
 {
@@ -61,6 +61,11 @@ protected:
   vtkSlicerBezierSurfaceWidget();
   ~vtkSlicerBezierSurfaceWidget();
 
+  /// Switch the Bezier surface to the interaction tessellation while the
+  /// widget is being interacted with
+  void StartWidgetInteraction(vtkEventData* startEventData) override;
+  void EndWidgetInteraction() override;
+
 private:
   vtkSlicerBezierSurfaceWidget(const vtkSlicerBezierSurfaceWidget&) = delete;
   void operator=(const vtkSlicerBezierSurfaceWidget) = delete;
@@ -61,12 +61,19 @@ vtkStandardNewMacro(vtkSlicerDistanceContourRepresentation3D);
 
 //------------------------------------------------------------------------------
 vtkSlicerDistanceContourRepresentation3D::vtkSlicerDistanceContourRepresentation3D()
-  :Superclass(), Target(nullptr)
+  :Superclass(), Target(nullptr), ContourNode(nullptr)
 {
 }
 
 //------------------------------------------------------------------------------
-vtkSlicerDistanceContourRepresentation3D::~vtkSlicerDistanceContourRepresentation3D() = default;
+vtkSlicerDistanceContourRepresentation3D::~vtkSlicerDistanceContourRepresentation3D()
+{
+  if (this->ShaderHelper)
+    {
+    this->ShaderHelper->RemoveContour(this->ContourNode);
+    this->ShaderHelper->UpdateContourUniforms();
+    }
+}
 
 //------------------------------------------------------------------------------
 void vtkSlicerDistanceContourRepresentation3D::PrintSelf(ostream& os, vtkIndent indent)
@@ -90,54 +97,48 @@ void vtkSlicerDistanceContourRepresentation3D::UpdateFromMRML(vtkMRMLNode* calle
 
  auto targetModelNode = liverMarkupsDistanceContourNode->GetTarget();
 
- // If the target model node has changed -> Reassign the contour shader
+ // If the target model node has changed -> Move the contour to the shader of the new target
  if (targetModelNode != this->Target)
    {
-   this->ShaderHelper->SetTargetModelNode(targetModelNode);
-   this->ShaderHelper->AttachDistanceContourShader();
+   if (this->ShaderHelper)
+     {
+     this->ShaderHelper->RemoveContour(this->ContourNode);
+     this->ShaderHelper->UpdateContourUniforms();
+     }
+   this->ShaderHelper = vtkSlicerShaderHelper::GetTargetShaderHelper(targetModelNode);
+   this->ContourNode = liverMarkupsDistanceContourNode;
+   if (this->ShaderHelper)
+     {
+     this->ShaderHelper->AddDistanceContour(this->ContourNode);
+     }
    this->Target = targetModelNode;
    }
 
- if (liverMarkupsDistanceContourNode->GetNumberOfControlPoints() != 2)
+ if (!this->ShaderHelper)
    {
    return;
    }
 
- // Recalculate the middle plane and update the shader parameters
+ // Hidden markups hide their contour too
+ auto markupsDisplayNode = this->GetMarkupsDisplayNode();
+ if (liverMarkupsDistanceContourNode->GetNumberOfControlPoints() != 2 ||
+     !markupsDisplayNode || !markupsDisplayNode->GetVisibility())
+   {
+   this->ShaderHelper->SetContourVisibility(this->ContourNode, false);
+   this->ShaderHelper->UpdateContourUniforms();
+   this->NeedToRenderOn();
+   return;
+   }
+
  double point1Position[3] = {1.0f};
  double point2Position[3] = {1.0f};
 
  liverMarkupsDistanceContourNode->GetNthControlPointPosition(0, point1Position);
  liverMarkupsDistanceContourNode->GetNthControlPointPosition(1, point2Position);
 
- auto VBOs = this->ShaderHelper->GetTargetModelVertexVBOs();
- auto actors = this->ShaderHelper->GetTargetActors();
-
- for(int index = 0; index < VBOs->GetNumberOfItems(); ++index)
-   {
-   auto VBO = vtkOpenGLVertexBufferObject::SafeDownCast(VBOs->GetItemAsObject(index));
-   auto scale = VBO->GetScale();
-   auto shift = VBO->GetShift();
-
-   float externalPointPositionScaled[4] = {
-     (point1Position[0] - shift[0]) * scale[0],
-     (point1Position[1] - shift[1]) * scale[1],
-     (point1Position[2] - shift[2]) * scale[2],
-     1.0f};
-
-   float referencePointPositionScaled[4] = {
-     (point2Position[0] - shift[0]) * scale[0],
-     (point2Position[1] - shift[1]) * scale[1],
-     (point2Position[2] - shift[2]) * scale[2],
-     1.0f};
-
-   auto actor = vtkActor::SafeDownCast(this->ShaderHelper->GetTargetActors()->GetItemAsObject(index));
-   auto fragmentUniforms = actor->GetShaderProperty()->GetFragmentCustomUniforms();
-   fragmentUniforms->SetUniform4f("externalPointMC", externalPointPositionScaled);
-   fragmentUniforms->SetUniform4f("referencePointMC", referencePointPositionScaled);
-   fragmentUniforms->SetUniformf("contourThickness", 2.0f*(scale[0]+scale[1])/2.0f);
-   fragmentUniforms->SetUniformi("contourVisibility", 1);
-   }
+ this->ShaderHelper->SetDistanceContourPoints(this->ContourNode, point1Position, point2Position);
+ this->ShaderHelper->SetContourVisibility(this->ContourNode, true);
+ this->ShaderHelper->UpdateContourUniforms();
 
  this->NeedToRenderOn();
 }
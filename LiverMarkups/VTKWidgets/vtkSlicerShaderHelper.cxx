@@ -43,6 +43,7 @@
 #include <qMRMLThreeDWidget.h>
 #include <vtkMRMLModelDisplayableManager.h>
 #include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLModelNode.h>
 
 // Slicer includes
 #include <qSlicerApplication.h>
@@ -58,244 +59,605 @@
 #include <vtkShaderProperty.h>
 #include <vtkUniforms.h>
 
+// STD includes
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+std::map<vtkMRMLModelNode*, vtkSlicerShaderHelper*>& GetTargetShaderHelpers()
+{
+  static std::map<vtkMRMLModelNode*, vtkSlicerShaderHelper*> targetShaderHelpers;
+  return targetShaderHelpers;
+}
+
+//------------------------------------------------------------------------------
+vtkOpenGLVertexBufferObject* GetActorVertexVBO(vtkActor* actor)
+{
+  auto modelMapper = vtkOpenGLPolyDataMapper::SafeDownCast(actor->GetMapper());
+  if (!modelMapper || !modelMapper->GetVBOs())
+    {
+    return nullptr;
+    }
+
+  // The VBO only exists once the actor has been rendered. Switching the
+  // shift and scale method is only done once, when the VBO is first seen.
+  auto vertexVBO = modelMapper->GetVBOs()->GetVBO("vertexMC");
+  if (vertexVBO &&
+      vertexVBO->GetCoordShiftAndScaleMethod() != vtkOpenGLVertexBufferObject::AUTO_SHIFT_SCALE)
+    {
+    vertexVBO->SetCoordShiftAndScaleMethod(vtkOpenGLVertexBufferObject::AUTO_SHIFT_SCALE);
+    }
+  return vertexVBO;
+}
+
+//------------------------------------------------------------------------------
+void AddContourShaderReplacements(vtkShaderProperty* shaderProperty)
+{
+  if (!shaderProperty)
+    {
+    return;
+    }
+
+  // The array sizes are fixed, so the uniform declarations never change
+  const std::string maximumNumberOfContours =
+    std::to_string(static_cast<int>(vtkSlicerShaderHelper::MaximumNumberOfContours));
+
+  shaderProperty->AddVertexShaderReplacement(
+    "//VTK::PositionVC::Dec",
+    true,
+    "//VTK::PositionVC::Dec\n"
+    "out vec4 vertexMCVSOutput;\n",
+    false
+  );
+
+  shaderProperty->AddVertexShaderReplacement(
+    "//VTK::PositionVC::Impl",
+    true,
+    "//VTK::PositionVC::Impl\n"
+    "vertexMCVSOutput = vertexMC;\n",
+    false
+  );
+
+  shaderProperty->AddFragmentShaderReplacement(
+    "//VTK::PositionVC::Dec",
+    true,
+    "//VTK::PositionVC::Dec\n"
+    "in vec4 vertexMCVSOutput;\n"
+    "vec4 fragPositionMC = vertexMCVSOutput;\n",
+    false
+  );
+
+  // Slicing contours: plane positions, and plane normals with the contour
+  // thickness in w. Distance contours: external points, and reference points
+  // with the contour thickness in w.
+  shaderProperty->AddFragmentShaderReplacement(
+    "//VTK::Color::Impl",
+    true,
+    "//VTK::Color::Impl\n"
+    "  vec3 contourColor= vec3(1.0, 1.0 ,1.0);\n"
+    "  bool onContour = false;\n"
+    "  for (int i = 0; i < " + maximumNumberOfContours + "; ++i){\n"
+    "    if (i >= numberOfSlicingContours){\n"
+    "      break;\n"
+    "    }\n"
+    "    vec3 w = fragPositionMC.xyz - planePositionsMC[i].xyz*fragPositionMC.w;\n"
+    "    float dist = dot(planeNormalsMC[i].xyz, w) / length(planeNormalsMC[i].xyz);\n"
+    "    onContour = onContour || abs(dist) < planeNormalsMC[i].w;\n"
+    "  }\n"
+    "  for (int i = 0; i < " + maximumNumberOfContours + "; ++i){\n"
+    "    if (i >= numberOfDistanceContours){\n"
+    "      break;\n"
+    "    }\n"
+    "    float refDist = distance(externalPointsMC[i].xyz, referencePointsMC[i].xyz);\n"
+    "    float dist = distance(referencePointsMC[i].xyz, fragPositionMC.xyz);\n"
+    "    onContour = onContour || abs(dist-refDist) < referencePointsMC[i].w;\n"
+    "  }\n"
+    "  if(onContour){\n"
+    "     ambientColor = contourColor;\n"
+    "     diffuseColor = contourColor;\n"
+    "     opacity = 1.0;\n"
+    "  }\n",
+    false
+  );
+
+  float zeros[vtkSlicerShaderHelper::MaximumNumberOfContours][4] = {{0.0f}};
+
+  auto fragmentUniforms = shaderProperty->GetFragmentCustomUniforms();
+  fragmentUniforms->SetUniform4fv("planePositionsMC", vtkSlicerShaderHelper::MaximumNumberOfContours, zeros);
+  fragmentUniforms->SetUniform4fv("planeNormalsMC", vtkSlicerShaderHelper::MaximumNumberOfContours, zeros);
+  fragmentUniforms->SetUniform4fv("externalPointsMC", vtkSlicerShaderHelper::MaximumNumberOfContours, zeros);
+  fragmentUniforms->SetUniform4fv("referencePointsMC", vtkSlicerShaderHelper::MaximumNumberOfContours, zeros);
+  fragmentUniforms->SetUniformi("numberOfSlicingContours", 0);
+  fragmentUniforms->SetUniformi("numberOfDistanceContours", 0);
+}
+
+} // namespace
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerShaderHelper);
 
 //------------------------------------------------------------------------------
 vtkSlicerShaderHelper::vtkSlicerShaderHelper()
-  :TargetModelNode(nullptr)
+  :TargetModelNode(nullptr),
+   TargetDisplayNode(nullptr),
+   NumberOfThreeDViews(0),
+   TargetActorsValid(false),
+   SlicingContoursModified(true),
+   DistanceContoursModified(true),
+   NumberOfUniformUpdates(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerShaderHelper::~vtkSlicerShaderHelper()
 {
+  // Hide the contours on the actors that outlive the helper
+  this->Contours.clear();
+  this->SlicingContoursModified = true;
+  this->DistanceContoursModified = true;
+  this->PushContourUniforms();
+
+  auto& targetShaderHelpers = GetTargetShaderHelpers();
+  for (auto it = targetShaderHelpers.begin(); it != targetShaderHelpers.end(); ++it)
+    {
+    if (it->second == this)
+      {
+      targetShaderHelpers.erase(it);
+      break;
+      }
+    }
 }
 
 //------------------------------------------------------------------------------
 void vtkSlicerShaderHelper::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreeDViews: " << this->NumberOfThreeDViews << "\n";
+  os << indent << "NumberOfTargetActors: " << this->TargetModelActors->GetNumberOfItems() << "\n";
+  os << indent << "NumberOfContours: " << this->Contours.size() << "\n";
+  os << indent << "NumberOfUniformUpdates: " << this->NumberOfUniformUpdates << "\n";
 }
 
 //------------------------------------------------------------------------------
-void vtkSlicerShaderHelper::AttachSlicingContourShader()
+vtkSmartPointer<vtkSlicerShaderHelper> vtkSlicerShaderHelper::GetTargetShaderHelper(vtkMRMLModelNode* modelNode)
 {
-  vtkNew<vtkCollection> propertiesCollection;
-  this->getShaderProperties(propertiesCollection.GetPointer());
+  if (!modelNode)
+    {
+    return nullptr;
+    }
 
-  for(int index=0; index<propertiesCollection->GetNumberOfItems(); ++index)
+  // A helper whose target was deleted may still be registered under the
+  // address of a new model node
+  auto& targetShaderHelpers = GetTargetShaderHelpers();
+  auto it = targetShaderHelpers.find(modelNode);
+  if (it != targetShaderHelpers.end() && it->second->GetTargetModelNode() == modelNode)
     {
-    auto shaderProperty =
-      vtkShaderProperty::SafeDownCast(propertiesCollection->GetItemAsObject(index));
-    if (!shaderProperty)
-      {
-      continue;
-      }
+    return it->second;
+    }
+
+  auto shaderHelper = vtkSmartPointer<vtkSlicerShaderHelper>::New();
+  shaderHelper->SetTargetModelNode(modelNode);
+  targetShaderHelpers[modelNode] = shaderHelper;
+  return shaderHelper;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::SetTargetModelNode(vtkMRMLModelNode* modelNode)
+{
+  if (this->TargetModelNode == modelNode)
+    {
+    return;
+    }
+
+  this->TargetModelNode = modelNode;
+  this->TargetDisplayNode = nullptr;
+  this->TargetActorEntries.clear();
+  this->TargetActorsValid = false;
+  this->UpdateTargetCollections();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::AddSlicingContour(vtkObject* contour)
+{
+  this->AddContour(contour, SlicingContour);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::AddDistanceContour(vtkObject* contour)
+{
+  this->AddContour(contour, DistanceContour);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::AddContour(vtkObject* contour, ContourType type)
+{
+  if (!contour)
+    {
+    return;
+    }
+
+  auto contourEntry = this->FindContour(contour);
+  if (contourEntry)
+    {
+    contourEntry->NumberOfReferences++;
+    return;
+    }
 
-    shaderProperty->AddVertexShaderReplacement(
-      "//VTK::PositionVC::Dec",
-      true,
-      "//VTK::PositionVC::Dec\n"
-      "out vec4 vertexMCVSOutput;\n",
-      false
-    );
-
-    shaderProperty->AddVertexShaderReplacement(
-      "//VTK::PositionVC::Impl",
-      true,
-      "//VTK::PositionVC::Impl\n"
-      "vertexMCVSOutput = vertexMC;\n",
-      false
-    );
-
-    shaderProperty->AddFragmentShaderReplacement(
-      "//VTK::PositionVC::Dec",
-      true,
-      "//VTK::PositionVC::Dec\n"
-      "in vec4 vertexMCVSOutput;\n"
-      "vec4 fragPositionMC = vertexMCVSOutput;\n",
-      false
-    );
-
-    shaderProperty->AddFragmentShaderReplacement(
-      "//VTK::Color::Impl",
-      true,
-      "//VTK::Color::Impl\n"
-      "  vec3 contourColor= vec3(1.0, 1.0 ,1.0);\n"
-      "  vec3 w = -(planePositionMC.xyz*fragPositionMC.w - fragPositionMC.xyz);\n"
-      "  float dist = (planeNormalMC.x * w.x + planeNormalMC.y * w.y + planeNormalMC.z * w.z) / sqrt( pow(planeNormalMC.x,2) + pow(planeNormalMC.y,2)+ pow(planeNormalMC.z,2));\n"
-      "  if(abs(dist) < contourThickness && contourVisibility != 0){\n"
-      "     ambientColor = contourColor;\n"
-      "     diffuseColor = contourColor;\n"
-      "     opacity = 1.0;\n"
-      "  }\n",
-      false
-    );
-
-    float position[] = {0.0f, 0.0f, 0.0f, 0.0f};
-    float normal[] = {1.0f, 0.0f, 0.0f, 0.0f};
-
-    auto fragmentUniforms = shaderProperty->GetFragmentCustomUniforms();
-    fragmentUniforms->SetUniform4f("planePositionMC", position);
-    fragmentUniforms->SetUniform4f("planeNormalMC", normal);
-    fragmentUniforms->SetUniformf("contourThickness", 0.05);
-    fragmentUniforms->SetUniformi("contourVisibility", 0);
+  int numberOfContours = static_cast<int>(std::count_if(this->Contours.begin(), this->Contours.end(),
+    [type](const ContourEntry& entry) { return entry.Type == type; }));
+  if (numberOfContours >= MaximumNumberOfContours)
+    {
+    vtkWarningMacro("More than " << MaximumNumberOfContours
+                    << " contours of the same kind on one target; the last ones are not drawn");
     }
+
+  ContourEntry newContourEntry = {contour, type, 1, false, {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}}};
+  // New contours are hidden, so the uniforms are not modified yet
+  this->Contours.push_back(newContourEntry);
 }
 
 //------------------------------------------------------------------------------
-void vtkSlicerShaderHelper::AttachDistanceContourShader()
+void vtkSlicerShaderHelper::RemoveContour(vtkObject* contour)
 {
-  vtkNew<vtkCollection> propertiesCollection;
-  this->getShaderProperties(propertiesCollection.GetPointer());
+  auto contourEntry = this->FindContour(contour);
+  if (!contourEntry || --contourEntry->NumberOfReferences > 0)
+    {
+    return;
+    }
+
+  if (contourEntry->Visible)
+    {
+    this->SetContoursModified(contourEntry->Type);
+    }
+  this->Contours.erase(this->Contours.begin() + (contourEntry - this->Contours.data()));
+}
 
-  for(int index=0; index<propertiesCollection->GetNumberOfItems(); ++index)
+//------------------------------------------------------------------------------
+vtkSlicerShaderHelper::ContourEntry* vtkSlicerShaderHelper::FindContour(vtkObject* contour)
+{
+  for (auto& contourEntry : this->Contours)
     {
-    auto shaderProperty =
-      vtkShaderProperty::SafeDownCast(propertiesCollection->GetItemAsObject(index));
-    if (!shaderProperty)
+    if (contourEntry.Contour == contour)
       {
-      continue;
+      return &contourEntry;
       }
-
-    shaderProperty->AddVertexShaderReplacement(
-      "//VTK::PositionVC::Dec",
-      true,
-      "//VTK::PositionVC::Dec\n"
-      "out vec4 vertexMCVSOutput;\n",
-      false
-    );
-
-    shaderProperty->AddVertexShaderReplacement(
-      "//VTK::PositionVC::Impl",
-      true,
-      "//VTK::PositionVC::Impl\n"
-      "vertexMCVSOutput = vertexMC;\n",
-      false
-    );
-
-    shaderProperty->AddFragmentShaderReplacement(
-      "//VTK::PositionVC::Dec",
-      true,
-      "//VTK::PositionVC::Dec\n"
-      "in vec4 vertexMCVSOutput;\n"
-      "vec4 fragPositionMC = vertexMCVSOutput;\n",
-      false
-    );
-
-    shaderProperty->AddFragmentShaderReplacement(
-      "//VTK::Color::Impl",
-      true,
-      "//VTK::Color::Impl\n"
-      "  vec3 contourColor= vec3(1.0, 1.0 ,1.0);\n"
-      "  float refDist= distance(externalPointMC, referencePointMC);\n"
-      "  float dist = distance(referencePointMC, fragPositionMC);\n"
-      "  if(abs(dist-refDist) < contourThickness && contourVisibility != 0){\n"
-      "     ambientColor = contourColor;\n"
-      "     diffuseColor = contourColor;\n"
-      "     opacity = 1.0;\n"
-      "  }\n",
-      false
-    );
-
-    float externalPointMC[] = {0.0f, 0.0f, 0.0f, 0.0f};
-    float referencePointMC[] = {0.0f, 0.0f, 0.0f, 0.0f};
-
-    auto fragmentUniforms = shaderProperty->GetFragmentCustomUniforms();
-    fragmentUniforms->SetUniform4f("externalPointMC", externalPointMC);
-    fragmentUniforms->SetUniform4f("referencePointMC", referencePointMC);
-    fragmentUniforms->SetUniformf("contourThickness", 0.05);
-    fragmentUniforms->SetUniformi("contourVisibility", 0);
     }
+  return nullptr;
 }
+
 //------------------------------------------------------------------------------
-void vtkSlicerShaderHelper::getShaderProperties(vtkCollection* propertiesCollection)
+void vtkSlicerShaderHelper::SetSlicingContourPlane(vtkObject* contour, const double origin[3],
+                                                   const double normal[3])
 {
+  auto contourEntry = this->FindContour(contour);
+  if (!contourEntry)
+    {
+    return;
+    }
 
-  if (!this->TargetModelNode)
+  if (std::equal(origin, origin + 3, contourEntry->Points[0]) &&
+      std::equal(normal, normal + 3, contourEntry->Points[1]))
     {
-    vtkWarningMacro("Invalid  model node");
     return;
     }
 
-  if (!propertiesCollection)
+  std::copy(origin, origin + 3, contourEntry->Points[0]);
+  std::copy(normal, normal + 3, contourEntry->Points[1]);
+  if (contourEntry->Visible)
+    {
+    this->SetContoursModified(SlicingContour);
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::SetDistanceContourPoints(vtkObject* contour, const double externalPoint[3],
+                                                     const double referencePoint[3])
+{
+  auto contourEntry = this->FindContour(contour);
+  if (!contourEntry)
     {
-    vtkWarningMacro("Invalid  properties collection");
     return;
     }
 
-  auto layoutManager = qSlicerApplication::application()->layoutManager();
-  if (!layoutManager)
+  if (std::equal(externalPoint, externalPoint + 3, contourEntry->Points[0]) &&
+      std::equal(referencePoint, referencePoint + 3, contourEntry->Points[1]))
     {
-    vtkWarningMacro("No valid layout manager");
     return;
     }
 
-  for (int threeDViewId = 0; threeDViewId < layoutManager->threeDViewCount(); ++threeDViewId)
+  std::copy(externalPoint, externalPoint + 3, contourEntry->Points[0]);
+  std::copy(referencePoint, referencePoint + 3, contourEntry->Points[1]);
+  if (contourEntry->Visible)
     {
+    this->SetContoursModified(DistanceContour);
+    }
+}
 
-    auto threeDWidget = layoutManager->threeDWidget(threeDViewId);
-    if (!threeDWidget)
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::SetContourVisibility(vtkObject* contour, bool visible)
+{
+  auto contourEntry = this->FindContour(contour);
+  if (!contourEntry || contourEntry->Visible == visible)
+    {
+    return;
+    }
+
+  contourEntry->Visible = visible;
+  this->SetContoursModified(contourEntry->Type);
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::SetContoursModified(ContourType type)
+{
+  if (type == SlicingContour)
+    {
+    this->SlicingContoursModified = true;
+    }
+  else
+    {
+    this->DistanceContoursModified = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::ResetNumberOfUniformUpdates()
+{
+  this->NumberOfUniformUpdates = 0;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::UpdateContourUniforms()
+{
+  this->UpdateTargetActors();
+  this->PushContourUniforms();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::PushContourUniforms()
+{
+  for (auto& entry : this->TargetActorEntries)
+    {
+    if (!entry.Actor || !entry.VertexVBO || !entry.Actor->GetShaderProperty())
       {
       continue;
       }
 
-    vtkNew<vtkCollection> displayableManagers;
-    threeDWidget->getDisplayableManagers(displayableManagers.GetPointer());
+    std::vector<double> scale = entry.VertexVBO->GetScale();
+    std::vector<double> shift = entry.VertexVBO->GetShift();
+    if (scale.size() != 3 || shift.size() != 3)
+      {
+      scale.assign(3, 1.0);
+      shift.assign(3, 0.0);
+      }
 
-    for(int index = 0; index < displayableManagers->GetNumberOfItems(); ++index)
+    // All the uniforms of an actor depend on the shift and scale of its VBO;
+    // otherwise only the arrays of the modified kind of contour are pushed
+    bool shiftScaleModified = !entry.UniformsValid || scale != entry.Scale || shift != entry.Shift;
+    bool pushSlicingContours = shiftScaleModified || this->SlicingContoursModified;
+    bool pushDistanceContours = shiftScaleModified || this->DistanceContoursModified;
+    if (!pushSlicingContours && !pushDistanceContours)
       {
+      continue;
+      }
+    entry.Scale = scale;
+    entry.Shift = shift;
+    entry.UniformsValid = true;
 
-      auto modelDisplayableManager =
-        vtkMRMLModelDisplayableManager::SafeDownCast(displayableManagers->GetItemAsObject(index));
-      if (!modelDisplayableManager)
+    // Contours are drawn in the shifted and scaled coordinates of the VBO
+    float contourThickness = 2.0f*static_cast<float>(scale[0]+scale[1])/2.0f;
+    auto toVBOCoordinates = [&](const double point[3], float w, float pointMC[4])
+      {
+      for (int i = 0; i < 3; ++i)
         {
-        continue;
+        pointMC[i] = static_cast<float>((point[i] - shift[i]) * scale[i]);
         }
+      pointMC[3] = w;
+      };
 
-      auto modelDisplayNode = this->TargetModelNode->GetDisplayNode();
-      if (!modelDisplayNode)
-        {
-        continue;
-        }
-      auto modelActor =
-        vtkActor::SafeDownCast(modelDisplayableManager->GetActorByID(modelDisplayNode->GetID()));
-      if (!modelActor)
+    auto fragmentUniforms = entry.Actor->GetShaderProperty()->GetFragmentCustomUniforms();
+
+    if (pushSlicingContours)
+      {
+      float planePositionsMC[MaximumNumberOfContours][4] = {{0.0f}};
+      float planeNormalsMC[MaximumNumberOfContours][4] = {{0.0f}};
+      int numberOfSlicingContours = 0;
+      for (const auto& contourEntry : this->Contours)
         {
-        continue;
+        if (!contourEntry.Visible || contourEntry.Type != SlicingContour ||
+            numberOfSlicingContours >= MaximumNumberOfContours)
+          {
+          continue;
+          }
+        toVBOCoordinates(contourEntry.Points[0], 1.0f, planePositionsMC[numberOfSlicingContours]);
+        for (int i = 0; i < 3; ++i)
+          {
+          planeNormalsMC[numberOfSlicingContours][i] = static_cast<float>(contourEntry.Points[1][i]);
+          }
+        planeNormalsMC[numberOfSlicingContours][3] = contourThickness;
+        numberOfSlicingContours++;
         }
 
-      this->TargetModelActors->AddItem(modelActor);
+      fragmentUniforms->SetUniform4fv("planePositionsMC", MaximumNumberOfContours, planePositionsMC);
+      fragmentUniforms->SetUniform4fv("planeNormalsMC", MaximumNumberOfContours, planeNormalsMC);
+      fragmentUniforms->SetUniformi("numberOfSlicingContours", numberOfSlicingContours);
+      this->NumberOfUniformUpdates += 3;
+      }
 
-      auto shaderProperty = modelActor->GetShaderProperty();
-      if (!shaderProperty)
+    if (pushDistanceContours)
+      {
+      float externalPointsMC[MaximumNumberOfContours][4] = {{0.0f}};
+      float referencePointsMC[MaximumNumberOfContours][4] = {{0.0f}};
+      int numberOfDistanceContours = 0;
+      for (const auto& contourEntry : this->Contours)
         {
-        continue;
+        if (!contourEntry.Visible || contourEntry.Type != DistanceContour ||
+            numberOfDistanceContours >= MaximumNumberOfContours)
+          {
+          continue;
+          }
+        toVBOCoordinates(contourEntry.Points[0], 1.0f, externalPointsMC[numberOfDistanceContours]);
+        toVBOCoordinates(contourEntry.Points[1], contourThickness, referencePointsMC[numberOfDistanceContours]);
+        numberOfDistanceContours++;
         }
 
-      // Cache the shader property
-      propertiesCollection->AddItem(shaderProperty);
+      fragmentUniforms->SetUniform4fv("externalPointsMC", MaximumNumberOfContours, externalPointsMC);
+      fragmentUniforms->SetUniform4fv("referencePointsMC", MaximumNumberOfContours, referencePointsMC);
+      fragmentUniforms->SetUniformi("numberOfDistanceContours", numberOfDistanceContours);
+      this->NumberOfUniformUpdates += 3;
+      }
+    }
 
-      // NOTE: Query and cache the target model VBOs as they are useful during update in the widget representation
+  this->SlicingContoursModified = false;
+  this->DistanceContoursModified = false;
+}
 
-      auto modelMapper =vtkOpenGLPolyDataMapper::SafeDownCast(modelActor->GetMapper());
-      if (!modelMapper)
-        {
-        vtkWarningMacro("Invalid model mapper");
-        continue;
-        }
+//------------------------------------------------------------------------------
+bool vtkSlicerShaderHelper::UpdateTargetActors()
+{
+  auto displayNode =
+    this->TargetModelNode ? this->TargetModelNode->GetDisplayNode() : nullptr;
+  auto application = qSlicerApplication::application();
+  auto layoutManager = application ? application->layoutManager() : nullptr;
+  int numberOfThreeDViews = layoutManager ? layoutManager->threeDViewCount() : 0;
+
+  bool valid = this->TargetActorsValid &&
+    displayNode == this->TargetDisplayNode &&
+    numberOfThreeDViews == this->NumberOfThreeDViews;
+
+  // The displayable manager of a removed view is gone, and a rebuilt actor is
+  // no longer the one registered for the display node
+  for (const auto& entry : this->TargetActorEntries)
+    {
+    if (!valid)
+      {
+      break;
+      }
+    valid = entry.DisplayableManager &&
+      entry.DisplayableManager->GetActorByID(displayNode->GetID()) == entry.Actor.GetPointer();
+    }
 
-      auto modelVBOs = modelMapper->GetVBOs();
-      if (!modelVBOs)
+  if (!valid)
+    {
+    this->RebuildTargetActors();
+    return true;
+    }
+
+  // The mapper may have replaced the VBO, e.g. after the mesh changed
+  bool vertexVBOsChanged = false;
+  for (auto& entry : this->TargetActorEntries)
+    {
+    auto vertexVBO = entry.Actor ? GetActorVertexVBO(entry.Actor) : nullptr;
+    if (vertexVBO != entry.VertexVBO)
+      {
+      entry.VertexVBO = vertexVBO;
+      entry.UniformsValid = false;
+      vertexVBOsChanged = true;
+      }
+    }
+  if (vertexVBOsChanged)
+    {
+    this->UpdateTargetCollections();
+    }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::RebuildTargetActors()
+{
+  std::vector<TargetActorEntry> previousEntries;
+  previousEntries.swap(this->TargetActorEntries);
+
+  this->TargetDisplayNode =
+    this->TargetModelNode ? this->TargetModelNode->GetDisplayNode() : nullptr;
+  this->NumberOfThreeDViews = 0;
+  this->TargetActorsValid = true;
+
+  auto application = qSlicerApplication::application();
+  auto layoutManager = application ? application->layoutManager() : nullptr;
+  if (!layoutManager)
+    {
+    vtkWarningMacro("No valid layout manager");
+    this->UpdateTargetCollections();
+    return;
+    }
+  this->NumberOfThreeDViews = layoutManager->threeDViewCount();
+
+  if (!this->TargetDisplayNode)
+    {
+    this->UpdateTargetCollections();
+    return;
+    }
+
+  for (int threeDViewId = 0; threeDViewId < this->NumberOfThreeDViews; ++threeDViewId)
+    {
+    auto threeDWidget = layoutManager->threeDWidget(threeDViewId);
+    if (!threeDWidget)
+      {
+      continue;
+      }
+
+    vtkNew<vtkCollection> displayableManagers;
+    threeDWidget->getDisplayableManagers(displayableManagers.GetPointer());
+
+    for (int index = 0; index < displayableManagers->GetNumberOfItems(); ++index)
+      {
+      auto modelDisplayableManager =
+        vtkMRMLModelDisplayableManager::SafeDownCast(displayableManagers->GetItemAsObject(index));
+      if (!modelDisplayableManager)
         {
-        vtkWarningMacro("Invalid model VBOs");
         continue;
         }
 
-      auto modelVertexVBO  = modelVBOs->GetVBO("vertexMC");
-      if (!modelVertexVBO)
+      TargetActorEntry entry;
+      entry.DisplayableManager = modelDisplayableManager;
+      entry.Actor =
+        vtkActor::SafeDownCast(modelDisplayableManager->GetActorByID(this->TargetDisplayNode->GetID()));
+      if (entry.Actor)
         {
-        vtkWarningMacro("Invalid model vertexMC VBO");
-        continue;
+        entry.VertexVBO = GetActorVertexVBO(entry.Actor);
+
+        // Actors that were already cached carry the shader, and their uniforms
+        // are still valid if the VBO is the same
+        auto previousEntry = std::find_if(previousEntries.begin(), previousEntries.end(),
+          [&entry](const TargetActorEntry& previous) { return previous.Actor == entry.Actor; });
+        if (previousEntry == previousEntries.end())
+          {
+          AddContourShaderReplacements(entry.Actor->GetShaderProperty());
+          }
+        else if (previousEntry->VertexVBO == entry.VertexVBO)
+          {
+          entry.Shift = previousEntry->Shift;
+          entry.Scale = previousEntry->Scale;
+          entry.UniformsValid = previousEntry->UniformsValid;
+          }
         }
+      this->TargetActorEntries.push_back(entry);
+      }
+    }
 
-      this->TargetModelVertexVBOs->AddItem(modelVertexVBO);
+  this->UpdateTargetCollections();
+}
+
+//------------------------------------------------------------------------------
+void vtkSlicerShaderHelper::UpdateTargetCollections()
+{
+  this->TargetModelActors->RemoveAllItems();
+  this->TargetModelVertexVBOs->RemoveAllItems();
+
+  for (const auto& entry : this->TargetActorEntries)
+    {
+    if (!entry.Actor || !entry.VertexVBO)
+      {
+      continue;
       }
+    this->TargetModelActors->AddItem(entry.Actor);
+    this->TargetModelVertexVBOs->AddItem(entry.VertexVBO);
     }
 }
+
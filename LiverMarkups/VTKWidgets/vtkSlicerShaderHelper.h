@@ -49,14 +49,26 @@
 #include <vtkActor.h>
 #include <vtkCollection.h>
 #include <vtkObject.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+// STD includes
+#include <vector>
+
 //------------------------------------------------------------------------------
 class vtkCollection;
+class vtkMRMLDisplayNode;
+class vtkMRMLModelDisplayableManager;
 class vtkMRMLModelNode;
+class vtkOpenGLVertexBufferObject;
 class vtkShaderProperty;
 
 //------------------------------------------------------------------------------
+/// Contour shader of a target model. All the slicing and distance contours
+/// drawn on the same target share one helper, which packs them into fixed
+/// size uniform arrays evaluated in a single fragment pass. Adding or
+/// removing contours only changes uniform values, so the shader of the
+/// target actors is never recompiled.
 class VTK_SLICER_LIVERMARKUPS_MODULE_VTKWIDGETS_EXPORT vtkSlicerShaderHelper
 : public vtkObject
 {
@@ -65,24 +77,118 @@ public:
   vtkTypeMacro(vtkSlicerShaderHelper, vtkObject);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
-  void SetTargetModelNode(vtkMRMLModelNode* modelNode){this->TargetModelNode = modelNode;}
+  /// Maximum number of slicing contours, and of distance contours, drawn on
+  /// one target. Further contours are ignored.
+  enum
+  {
+    MaximumNumberOfContours = 16
+  };
+
+  /// Get the helper shared by all contours on the given target model,
+  /// creating it if needed. The helper lives as long as a contour
+  /// representation holds it.
+  static vtkSmartPointer<vtkSlicerShaderHelper> GetTargetShaderHelper(vtkMRMLModelNode* modelNode);
+
+  /// Set the model the contour shader is attached to. This drops the cached
+  /// actors of the previous target.
+  void SetTargetModelNode(vtkMRMLModelNode* modelNode);
   vtkMRMLModelNode* GetTargetModelNode(){return this->TargetModelNode;}
+
+  /// Actors of the target model in the 3D views and their vertexMC VBOs. Both
+  /// collections are parallel (the n-th VBO belongs to the n-th actor) and
+  /// only list actors whose VBO has been created already. Call
+  /// UpdateTargetActors() before using them.
   vtkCollection* GetTargetModelVertexVBOs(){return this->TargetModelVertexVBOs;}
   vtkCollection* GetTargetActors(){return this->TargetModelActors;}
-  void AttachSlicingContourShader();
-  void AttachDistanceContourShader();
+
+  /// Check that the cached actors are still the ones displaying the target
+  /// model, at a cost of one actor lookup per 3D view. The cache is rebuilt
+  /// when 3D views were added or removed, or the model displayable manager
+  /// rebuilt the actor; new actors get the contour shader. Returns true if
+  /// the cache was rebuilt.
+  bool UpdateTargetActors();
+
+  /// Register a contour drawn on the target. Contours are identified by their
+  /// markups node, so the representations of one node in several views
+  /// share a single contour. Each Add call needs a matching RemoveContour.
+  void AddSlicingContour(vtkObject* contour);
+  void AddDistanceContour(vtkObject* contour);
+  void RemoveContour(vtkObject* contour);
+
+  /// Set the plane of a slicing contour, in world coordinates.
+  void SetSlicingContourPlane(vtkObject* contour, const double origin[3], const double normal[3]);
+
+  /// Set the points of a distance contour, in world coordinates. The contour
+  /// is the set of points as far from the reference point as the external
+  /// point is.
+  void SetDistanceContourPoints(vtkObject* contour, const double externalPoint[3],
+                                const double referencePoint[3]);
+
+  /// Hidden contours keep their slot but are not drawn.
+  void SetContourVisibility(vtkObject* contour, bool visible);
+
+  /// Push the visible contours to the shader uniforms of the target actors.
+  /// Only the uniforms affected since the last push are set: the arrays of
+  /// the kind of contour that was added, removed, moved or shown/hidden, and
+  /// all of them on actors whose VBO shift and scale changed.
+  void UpdateContourUniforms();
+
+  /// Number of uniforms set on the target actors, to check the uniform
+  /// traffic of an interaction.
+  vtkGetMacro(NumberOfUniformUpdates, vtkTypeUInt64);
+  void ResetNumberOfUniformUpdates();
 
 protected:
+  enum ContourType
+  {
+    SlicingContour = 0,
+    DistanceContour
+  };
+
+  /// Contour registered by one or more representations
+  struct ContourEntry
+  {
+    vtkObject* Contour;
+    ContourType Type;
+    int NumberOfReferences;
+    bool Visible;
+    double Points[2][3];
+  };
+
+  /// Target model actor in one 3D view
+  struct TargetActorEntry
+  {
+    vtkWeakPointer<vtkMRMLModelDisplayableManager> DisplayableManager;
+    vtkWeakPointer<vtkActor> Actor;
+    vtkWeakPointer<vtkOpenGLVertexBufferObject> VertexVBO;
+    std::vector<double> Shift; // VBO shift of the pushed uniforms
+    std::vector<double> Scale; // VBO scale of the pushed uniforms
+    bool UniformsValid = false;
+  };
+
   vtkWeakPointer<vtkMRMLModelNode> TargetModelNode;
+  vtkWeakPointer<vtkMRMLDisplayNode> TargetDisplayNode;
   vtkNew<vtkCollection> TargetModelVertexVBOs;
   vtkNew<vtkCollection> TargetModelActors;
+  std::vector<TargetActorEntry> TargetActorEntries;
+  std::vector<ContourEntry> Contours;
+  int NumberOfThreeDViews;
+  bool TargetActorsValid;
+  bool SlicingContoursModified;
+  bool DistanceContoursModified;
+  vtkTypeUInt64 NumberOfUniformUpdates;
 
 protected:
   vtkSlicerShaderHelper();
-  ~vtkSlicerShaderHelper() = default;
+  ~vtkSlicerShaderHelper() override;
 
 private:
-  void getShaderProperties(vtkCollection* propertiesCollection);
+  void AddContour(vtkObject* contour, ContourType type);
+  ContourEntry* FindContour(vtkObject* contour);
+  void SetContoursModified(ContourType type);
+  void RebuildTargetActors();
+  void UpdateTargetCollections();
+  void PushContourUniforms();
 
 private:
   vtkSlicerShaderHelper(const vtkSlicerShaderHelper&) = delete;
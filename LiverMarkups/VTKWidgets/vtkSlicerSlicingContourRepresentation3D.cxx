@@ -61,12 +61,19 @@ vtkStandardNewMacro(vtkSlicerSlicingContourRepresentation3D);
 
 //------------------------------------------------------------------------------
 vtkSlicerSlicingContourRepresentation3D::vtkSlicerSlicingContourRepresentation3D()
-  :Superclass(), Target(nullptr)
+  :Superclass(), Target(nullptr), ContourNode(nullptr)
 {
 }
 
 //------------------------------------------------------------------------------
-vtkSlicerSlicingContourRepresentation3D::~vtkSlicerSlicingContourRepresentation3D() = default;
+vtkSlicerSlicingContourRepresentation3D::~vtkSlicerSlicingContourRepresentation3D()
+{
+  if (this->ShaderHelper)
+    {
+    this->ShaderHelper->RemoveContour(this->ContourNode);
+    this->ShaderHelper->UpdateContourUniforms();
+    }
+}
 
 //------------------------------------------------------------------------------
 void vtkSlicerSlicingContourRepresentation3D::PrintSelf(ostream& os, vtkIndent indent)
@@ -90,19 +97,39 @@ void vtkSlicerSlicingContourRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller
 
  auto targetModelNode = liverMarkupsSlicingContourNode->GetTarget();
 
- // If the target model node has changed -> Reassign the contour shader
+ // If the target model node has changed -> Move the contour to the shader of the new target
  if (targetModelNode != this->Target)
    {
-   this->ShaderHelper->SetTargetModelNode(targetModelNode);
-   this->ShaderHelper->AttachSlicingContourShader();
+   if (this->ShaderHelper)
+     {
+     this->ShaderHelper->RemoveContour(this->ContourNode);
+     this->ShaderHelper->UpdateContourUniforms();
+     }
+   this->ShaderHelper = vtkSlicerShaderHelper::GetTargetShaderHelper(targetModelNode);
+   this->ContourNode = liverMarkupsSlicingContourNode;
+   if (this->ShaderHelper)
+     {
+     this->ShaderHelper->AddSlicingContour(this->ContourNode);
+     }
    this->Target = targetModelNode;
    }
 
- if (liverMarkupsSlicingContourNode->GetNumberOfControlPoints() != 2)
+ if (!this->ShaderHelper)
    {
    return;
    }
 
+ // Hidden markups hide their contour too
+ auto markupsDisplayNode = this->GetMarkupsDisplayNode();
+ if (liverMarkupsSlicingContourNode->GetNumberOfControlPoints() != 2 ||
+     !markupsDisplayNode || !markupsDisplayNode->GetVisibility())
+   {
+   this->ShaderHelper->SetContourVisibility(this->ContourNode, false);
+   this->ShaderHelper->UpdateContourUniforms();
+   this->NeedToRenderOn();
+   return;
+   }
+
  // Recalculate the middle plane and update the shader parameters
  double point1Position[3] = {1.0f};
  double point2Position[3] = {1.0f};
@@ -110,62 +137,22 @@ void vtkSlicerSlicingContourRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller
  liverMarkupsSlicingContourNode->GetNthControlPointPosition(0, point1Position);
  liverMarkupsSlicingContourNode->GetNthControlPointPosition(1, point2Position);
 
- float middlePointPosition[3] = {
-   static_cast<float>(point2Position[0] + point1Position[0]) / 2.0f,
-   static_cast<float>(point2Position[1] + point1Position[1]) / 2.0f,
-   static_cast<float>(point2Position[2] + point1Position[2]) / 2.0f
+ double middlePointPosition[3] = {
+   (point2Position[0] + point1Position[0]) / 2.0,
+   (point2Position[1] + point1Position[1]) / 2.0,
+   (point2Position[2] + point1Position[2]) / 2.0
  };
 
- float planeNormal[4] = {
-   static_cast<float>(point2Position[0] - point1Position[0]),
-   static_cast<float>(point2Position[1] - point1Position[1]),
-   static_cast<float>(point2Position[2] - point1Position[2]),
-   1.0f
+ double planeNormal[3] = {
+   point2Position[0] - point1Position[0],
+   point2Position[1] - point1Position[1],
+   point2Position[2] - point1Position[2]
  };
+ vtkMath::Normalize(planeNormal);
 
- float planeNormalNorm = vtkMath::Normalize(planeNormal);
- planeNormal[0] /= planeNormalNorm;
- planeNormal[1] /= planeNormalNorm;
- planeNormal[2] /= planeNormalNorm;
-
- auto VBOs = this->ShaderHelper->GetTargetModelVertexVBOs();
- auto actors = this->ShaderHelper->GetTargetActors();
-
- for(int index = 0; index < VBOs->GetNumberOfItems(); ++index)
-   {
-   auto VBO = vtkOpenGLVertexBufferObject::SafeDownCast(VBOs->GetItemAsObject(index));
-   if(!VBO)
-     {
-     vtkErrorMacro("Error: could not retrieve vtkOpenGLVertexBufferObject");
-     return;
-     }
-
-   VBO->SetCoordShiftAndScaleMethod(vtkOpenGLVertexBufferObject::AUTO_SHIFT_SCALE);
-   auto scale = VBO->GetScale();
-   auto shift = VBO->GetShift();
-
-   if (scale.size() != 3  || shift.size() != 3)
-     {
-     scale.clear();
-     scale.push_back(1.0f);scale.push_back(1.0f);scale.push_back(1.0f);
-     shift.clear();
-     shift.push_back(0.0f);shift.push_back(0.0f);shift.push_back(0.0f);
-     return;
-     }
-
-   float middlePointPositionScaled[4] = {
-     (middlePointPosition[0] - shift[0]) * scale[0],
-     (middlePointPosition[1] - shift[1]) * scale[1],
-     (middlePointPosition[2] - shift[2]) * scale[2],
-     1.0f};
-
-   auto actor = vtkActor::SafeDownCast(this->ShaderHelper->GetTargetActors()->GetItemAsObject(index));
-   auto fragmentUniforms = actor->GetShaderProperty()->GetFragmentCustomUniforms();
-   fragmentUniforms->SetUniform4f("planePositionMC", middlePointPositionScaled);
-   fragmentUniforms->SetUniform4f("planeNormalMC", planeNormal);
-   fragmentUniforms->SetUniformf("contourThickness", 2.0f*(scale[0]+scale[1])/2.0f);
-   fragmentUniforms->SetUniformi("contourVisibility", 1);
-   }
+ this->ShaderHelper->SetSlicingContourPlane(this->ContourNode, middlePointPosition, planeNormal);
+ this->ShaderHelper->SetContourVisibility(this->ContourNode, true);
+ this->ShaderHelper->UpdateContourUniforms();
 
  this->NeedToRenderOn();
 }
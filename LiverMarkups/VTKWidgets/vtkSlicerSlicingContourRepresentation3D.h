@@ -50,6 +50,7 @@
 #include <vtkMRMLModelNode.h>
 
 // VTK includes
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
 
@@ -70,7 +71,10 @@ protected:
 
 private:
   vtkWeakPointer<vtkMRMLModelNode> Target;
-  vtkNew<vtkSlicerShaderHelper> ShaderHelper;
+  vtkSmartPointer<vtkSlicerShaderHelper> ShaderHelper;
+
+  /// Markups node identifying the contour in the shader helper of the target
+  vtkObject* ContourNode;
 
 private:
   vtkSlicerSlicingContourRepresentation3D(const vtkSlicerSlicingContourRepresentation3D&) = delete;
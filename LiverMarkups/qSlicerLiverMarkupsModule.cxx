@@ -41,6 +41,7 @@
 
 // MRML includes
 #include "vtkMRMLMarkupsBezierSurfaceNode.h"
+#include "vtkMRMLMarkupsBSplineSurfaceNode.h"
 #include "vtkMRMLMarkupsSlicingContourNode.h"
 #include "vtkMRMLMarkupsDistanceContourNode.h"
 
@@ -60,6 +61,7 @@
 #include "vtkSlicerSlicingContourWidget.h"
 #include "vtkSlicerDistanceContourWidget.h"
 #include "vtkSlicerBezierSurfaceWidget.h"
+#include "vtkSlicerBSplineSurfaceWidget.h"
 
 #include <qSlicerModuleManager.h>
 #include <qSlicerCoreApplication.h>
@@ -173,6 +175,10 @@ void qSlicerLiverMarkupsModule::setup()
  vtkNew<vtkSlicerBezierSurfaceWidget> bezierSurfaceWidget;
  markupsLogic->RegisterMarkupsNode(bezierSurfaceNode, bezierSurfaceWidget);
 
+ vtkNew<vtkMRMLMarkupsBSplineSurfaceNode> bsplineSurfaceNode;
+ vtkNew<vtkSlicerBSplineSurfaceWidget> bsplineSurfaceWidget;
+ markupsLogic->RegisterMarkupsNode(bsplineSurfaceNode, bsplineSurfaceWidget);
+
  // qSlicerModuleManager* moduleManager = qSlicerCoreApplication::application()->moduleManager();
  // if (!moduleManager)
  //   {
@@ -206,7 +212,8 @@ QStringList qSlicerLiverMarkupsModule::associatedNodeTypes() const
   return QStringList()
     << "vtkMRMLMarkupsSlicingContourNode"
     << "vtkMRMLMarkupsDistanceContourNode"
-    << "vtkMRMLMarkupsBezierSurfaceNode";
+    << "vtkMRMLMarkupsBezierSurfaceNode"
+    << "vtkMRMLMarkupsBSplineSurfaceNode";
 }
 
 //-----------------------------------------------------------------------------